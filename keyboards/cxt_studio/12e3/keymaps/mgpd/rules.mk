@@ -1 +1,3 @@
+USER_NAME := muge
+
 ENCODER_MAP_ENABLE = yes
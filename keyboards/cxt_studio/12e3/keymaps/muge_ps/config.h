@@ -0,0 +1,19 @@
+// Copyright 2023 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/* Learn a tapping term per TH_* key from observed press durations */
+#define TH_ADAPTIVE_TERM
+
+/* Learned terms, one uint16_t per tap-hold slot */
+#define EECONFIG_USER_DATA_SIZE 32
+
+/* Encoder detents are queued by users/muge/knob.c, no need to wait between press and release */
+#undef ENCODER_MAP_KEY_DELAY
+#define ENCODER_MAP_KEY_DELAY 0
+
+/* Hi-res wheel, each left knob detent scrolls a quarter notch */
+#define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define WHEEL_EXTENDED_REPORT
+#define KNOB_HIRES_DIVISOR 4
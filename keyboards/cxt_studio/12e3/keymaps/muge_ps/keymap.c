@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include QMK_KEYBOARD_H
+#include "muge.h"
 
 #define TAP_TIME_DEF 175
 
@@ -12,18 +13,23 @@ enum my_layers {
 };
 
 enum custom_keycodes {
+    // tap-hold keys, kept contiguous so th_keys[] can be indexed directly
     TH_DX = SAFE_RANGE,
-    CCUNDO, CCREDO,
     TH_BS, TH_JE, TH_VW, TH_GSP, TH_ML, TH_F1D, TH_05, TH_1T, TH_CX, TH_PST, TH_SAV,
+    CCUNDO, CCREDO,
     PS_ZI, PS_ZO,
 };
 
-const uint16_t PROGMEM pslayeron_combo[] = {KC_ESC, C(KC_X), C(KC_C), COMBO_END};
-const uint16_t PROGMEM pslayeroff_combo[] = {KC_C, KC_D, COMBO_END};
-combo_t key_combos[] = {
-    COMBO(pslayeron_combo, TG(1)),
-    COMBO(pslayeroff_combo, TG(1)), // keycodes with modifiers are possible too!
+#define TH_FIRST TH_DX
+#define TH_LAST TH_SAV
+#define TH_COUNT (TH_LAST - TH_FIRST + 1)
+
+const pos_combo_t PROGMEM pos_combos[] = {
+    POS_COMBO(TG(1), KC_ESC, C(KC_X), C(KC_C)), // pslayeron
+    POS_COMBO(TG(1), KC_C, KC_D),               // pslayeroff
 };
+const uint8_t pos_combo_count = ARRAY_SIZE(pos_combos);
+_Static_assert(ARRAY_SIZE(pos_combos) <= POS_COMBO_MAX, "raise POS_COMBO_MAX in config.h");
 
 
 const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
@@ -68,23 +74,62 @@ const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][NUM_DIRECTIONS] = {
 };
 #endif
 
+/* Encoder acceleration, one curve per encoder and layer. See users/muge/knob.h. */
+// clang-format off
+const knob_curve_t PROGMEM knob_curves[][NUM_ENCODERS] = {
+    // Encoders: Left, Right, Big
+    [_BASE] = { KNOB_CURVE(60, 6), KNOB_NONE,         KNOB_CURVE(40, 4) },
+    [_PS]   = { KNOB_CURVE(60, 4), KNOB_CURVE(60, 3), KNOB_CURVE(40, 4) },
+};
+// clang-format on
+const uint8_t knob_curve_layers = ARRAY_SIZE(knob_curves);
+
+
+/* Tap-hold keys, one row per TH_* keycode. See users/muge/tap_hold.h. */
+#define LCTL_BIT MOD_BIT(KC_LCTL)
+#define LSFT_BIT MOD_BIT(KC_LSFT)
+
+#define TH(tap, tap_mods, hold, hold_mods) TAP_HOLD(tap, tap_mods, hold, hold_mods, TH_F_EAGER, TAP_TIME_DEF)
+#define TH_RPT(tap, hold) TAP_HOLD(tap, 0, hold, 0, TH_F_EAGER | TH_F_REPEAT, TAP_TIME_DEF)
+
+// clang-format off
+const th_key_t PROGMEM th_keys[TH_COUNT] = {
+    [TH_DX  - TH_FIRST] = TH(KC_D, 0,        KC_X,  0),
+    [TH_BS  - TH_FIRST] = TH(KC_B, 0,        KC_S,  0),
+    [TH_JE  - TH_FIRST] = TH(KC_J, LCTL_BIT, KC_E,  0),
+    [TH_VW  - TH_FIRST] = TH(KC_V, 0,        KC_W,  0),
+    [TH_GSP - TH_FIRST] = TH_RPT(KC_G, KC_SPC),
+    [TH_ML  - TH_FIRST] = TH(KC_M, 0,        KC_L,  0),
+    [TH_F1D - TH_FIRST] = TH(KC_F, 0,        KC_D,  LCTL_BIT),
+    [TH_05  - TH_FIRST] = TH(KC_0, 0,        KC_5,  0),
+    [TH_1T  - TH_FIRST] = TH(KC_1, LCTL_BIT, KC_T,  LCTL_BIT),
+    [TH_CX  - TH_FIRST] = TH(KC_C, LCTL_BIT, KC_X,  LCTL_BIT),
+    [TH_PST - TH_FIRST] = TH(KC_V, LCTL_BIT, KC_V,  LCTL_BIT | LSFT_BIT),
+    [TH_SAV - TH_FIRST] = TH(KC_S, LCTL_BIT, KC_S,  LCTL_BIT | LSFT_BIT),
+};
+// clang-format on
+
+const uint8_t th_key_count = TH_COUNT;
+
+_Static_assert(TH_COUNT <= TAP_HOLD_MAX_KEYS, "raise TAP_HOLD_MAX_KEYS");
+
+bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
+    if (keycode >= TH_FIRST && keycode <= TH_LAST) {
+        return process_tap_hold(keycode - TH_FIRST, record);
+    }
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     switch (keycode) {
+        // Alt stays down until the wheel report is sent, see knob_mod_wheel()
         case PS_ZI:
             if (record->event.pressed) {
-                register_code16(A(MS_WHLU));
-            } else {
-                unregister_code16(A(MS_WHLU));
+                knob_mod_wheel(MS_WHLU, MOD_BIT(KC_LALT));
             }
-            return true;
+            return false;
         case PS_ZO:
             if (record->event.pressed) {
-                register_code16(A(MS_WHLD));
-            } else {
-                unregister_code16(A(MS_WHLD));
+                knob_mod_wheel(MS_WHLD, MOD_BIT(KC_LALT));
             }
-            return true;
+            return false;
         case CCUNDO:
             register_mods(MOD_BIT(KC_LCTL));
             tap_code16(KC_Z);
@@ -95,175 +140,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
             tap_code16(KC_Z);
             unregister_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
             return true;
-        case TH_DX:
-            static uint16_t cdx_timer;
-            if (record->event.pressed) {
-                cdx_timer = timer_read();
-            } else {
-                if (timer_elapsed(cdx_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_D);
-                } else {
-                    tap_code16(KC_X);
-                }
-            }
-            return false;
-        case TH_ML:
-            static uint16_t cml_timer;
-            if (record->event.pressed) {
-                cml_timer = timer_read();
-            } else {
-                if (timer_elapsed(cml_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_M);
-                } else {
-                    tap_code16(KC_L);
-                }
-            }
-            return false;
-
-        case TH_BS:
-            static uint16_t cbs_timer;
-            if (record->event.pressed) {
-                cbs_timer = timer_read();
-            } else {
-                if (timer_elapsed(cbs_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_B);
-                } else {
-                    tap_code16(KC_S);
-                }
-            }
-            return false;
-        case TH_GSP:
-            static uint16_t cgsp_timer;
-            if (record->event.pressed) {
-                cgsp_timer = timer_read();
-                if (timer_elapsed(cgsp_timer) > TAP_TIME_DEF) {
-                    tap_code16(KC_SPC);
-                }
-            } else {
-                if (timer_elapsed(cgsp_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_G);
-                } else {
-                    //tap_code16(KC_SPC);
-                }
-            }
-            return false;
-        case TH_VW:
-            static uint16_t cvw_timer;
-            if (record->event.pressed) {
-                cvw_timer = timer_read();
-            } else {
-                if (timer_elapsed(cvw_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_V);
-                } else {
-                    tap_code16(KC_W);
-                }
-            }
-            return false;
-        case TH_JE:
-            static uint16_t cje_timer;
-            if (record->event.pressed) {
-                cje_timer = timer_read();
-            } else {
-                if (timer_elapsed(cje_timer) < TAP_TIME_DEF) {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_J);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                } else {
-                    tap_code16(KC_E);
-                }
-            }
-            return false;
-        case TH_F1D:
-            static uint16_t cfd_timer;
-            if (record->event.pressed) {
-                cfd_timer = timer_read();
-            } else {
-                if (timer_elapsed(cfd_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_F);
-                } else {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_D);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                }
-            }
-            return false;
-        case TH_05:
-            static uint16_t c05_timer;
-            if (record->event.pressed) {
-                c05_timer = timer_read();
-            } else {
-                if (timer_elapsed(c05_timer) < TAP_TIME_DEF) {
-                    tap_code16(KC_0);
-                } else {
-                    tap_code16(KC_5);
-                }
-            }
-            return false;
-        case TH_1T:
-            static uint16_t c1t_timer;
-            if (record->event.pressed) {
-                c1t_timer = timer_read();
-            } else {
-                if (timer_elapsed(c1t_timer) < TAP_TIME_DEF) {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_1);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                } else {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_T);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                }
-            }
-            return false;
-        case TH_CX:
-            static uint16_t ccx_timer;
-            if (record->event.pressed) {
-                ccx_timer = timer_read();
-            } else {
-                if (timer_elapsed(ccx_timer) < TAP_TIME_DEF) {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_C);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                } else {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_X);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                }
-            }
-            return false;
-        case TH_PST:
-            static uint16_t cpst_timer;
-            if (record->event.pressed) {
-                cpst_timer = timer_read();
-            } else {
-                if (timer_elapsed(cpst_timer) < TAP_TIME_DEF) {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_V);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                } else {
-                    register_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
-                    tap_code16(KC_V);
-                    unregister_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
-                }
-            }
-            return false;
-        case TH_SAV:
-            static uint16_t csav_timer;
-            if (record->event.pressed) {
-                csav_timer = timer_read();
-            } else {
-                if (timer_elapsed(csav_timer) < TAP_TIME_DEF) {
-                    register_mods(MOD_BIT(KC_LCTL));
-                    tap_code16(KC_S);
-                    unregister_mods(MOD_BIT(KC_LCTL));
-                } else {
-                    register_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
-                    tap_code16(KC_S);
-                    unregister_mods(MOD_BIT(KC_LCTL) | MOD_BIT(KC_LSFT));
-                }
-            }
-            return false;
-
     }
     return true;
 };
@@ -1,2 +1,9 @@
+USER_NAME := muge
+
 ENCODER_MAP_ENABLE = yes
-COMBO_ENABLE = yes
+MUGE_KNOB_ENABLE = yes
+# wheel detents leave as one report through the pointing device task
+POINTING_DEVICE_ENABLE = yes
+POINTING_DEVICE_DRIVER = custom
+MUGE_POS_COMBO_ENABLE = yes
+MUGE_TAP_HOLD_ENABLE = yes
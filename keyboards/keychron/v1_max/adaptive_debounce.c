@@ -0,0 +1,147 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Per-key adaptive eager debounce.
+ *
+ * Like sym_eager_pk, a change is reported the moment a key's raw state
+ * differs from its debounced state. Further changes on that key are then
+ * ignored for a lockout window, so ordinary contact bounce inside it is
+ * never seen. The window differs per key:
+ * - A change within ADAPTIVE_DEBOUNCE_GRACE ms after the window closes is
+ *   bounce that outlasted the window, i.e. chatter. It is reported (that is
+ *   what the raw state says) and puts the key straight back at DEBOUNCE.
+ * - Every ADAPTIVE_DEBOUNCE_STREAK windows in a row followed by a quiet
+ *   grace period move it one level towards ADAPTIVE_DEBOUNCE_MIN.
+ *
+ * Keys start at DEBOUNCE, so a switch only gets faster once it has shown
+ * that it is clean.
+ *
+ * Each key costs two bytes: the remaining lockout or grace time in ms, and
+ * the level, clean streak and in-grace bit packed into one byte.
+ */
+
+#include "quantum.h"
+#include "debounce.h"
+#include "profiler.h"
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+#ifndef ADAPTIVE_DEBOUNCE_MIN
+#    define ADAPTIVE_DEBOUNCE_MIN 2
+#endif
+#ifndef ADAPTIVE_DEBOUNCE_STREAK
+#    define ADAPTIVE_DEBOUNCE_STREAK 7 // clean windows per level, at most 7
+#endif
+#ifndef ADAPTIVE_DEBOUNCE_GRACE
+#    define ADAPTIVE_DEBOUNCE_GRACE DEBOUNCE // ms after a window in which a change is chatter
+#endif
+
+#define LEVEL_MAX 15
+#define LEVEL(a) ((a) >> 4)
+#define STREAK(a) (((a) >> 1) & 0x7)
+#define GRACE 0x01
+#define PACK(level, streak) ((level) << 4 | (streak) << 1)
+
+_Static_assert(DEBOUNCE <= UINT8_MAX, "lockout counters are kept in a byte");
+_Static_assert(ADAPTIVE_DEBOUNCE_STREAK <= 7, "the streak is kept in three bits");
+_Static_assert(ADAPTIVE_DEBOUNCE_GRACE >= 1 && ADAPTIVE_DEBOUNCE_GRACE <= UINT8_MAX, "the grace period is kept in the lockout byte");
+
+static uint8_t      lockout[MATRIX_ROWS][MATRIX_COLS];
+static uint8_t      adapt[MATRIX_ROWS][MATRIX_COLS];
+static bool         counters_active;
+static fast_timer_t last_time;
+
+static uint8_t window(uint8_t a) {
+    return ADAPTIVE_DEBOUNCE_MIN + (DEBOUNCE - ADAPTIVE_DEBOUNCE_MIN) * LEVEL(a) / LEVEL_MAX;
+}
+
+// Moves the key's level after a window and its grace period, depending on
+// whether the key changed again within them.
+static uint8_t adapt_window(uint8_t a, bool chatter) {
+    uint8_t level  = LEVEL(a);
+    uint8_t streak = STREAK(a);
+
+    if (chatter) {
+        return PACK(LEVEL_MAX, 0);
+    }
+    if (++streak < ADAPTIVE_DEBOUNCE_STREAK) {
+        return PACK(level, streak);
+    }
+    return PACK(level ? level - 1 : 0, 0);
+}
+
+void debounce_init(uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            lockout[row][col] = 0;
+            adapt[row][col]   = PACK(LEVEL_MAX, 0);
+        }
+    }
+}
+
+// Returns whether any cooked bit changed, as QMK's own debounce does.
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint8_t elapsed        = 0;
+    bool    cooked_changed = false;
+
+    if (counters_active) {
+        fast_timer_t now = timer_read_fast();
+
+        elapsed   = MIN(TIMER_DIFF_FAST(now, last_time), UINT8_MAX);
+        last_time = now;
+    } else if (changed) {
+        last_time = timer_read_fast();
+    } else {
+        return false;
+    }
+
+    uint32_t start = profiler_begin();
+
+    counters_active = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta = raw[row] ^ cooked[row];
+
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t bit   = MATRIX_ROW_SHIFTER << col;
+            uint8_t     *left  = &lockout[row][col];
+            uint8_t     *a     = &adapt[row][col];
+            uint8_t      spent = elapsed;
+
+            if (*left && !(*a & GRACE)) {
+                if (*left > spent) {
+                    *left -= spent;
+                    counters_active = true;
+                    continue;
+                }
+                // window closed: from here on a change is bounce it missed
+                *a |= GRACE;
+                *left = ADAPTIVE_DEBOUNCE_GRACE;
+                spent = 0;
+            }
+            if (*a & GRACE) {
+                if (delta & bit) {
+                    *a = adapt_window(*a, true);
+                } else if (*left > spent) {
+                    *left -= spent;
+                    counters_active = true;
+                    continue;
+                } else {
+                    *a    = adapt_window(*a, false);
+                    *left = 0;
+                    continue;
+                }
+            }
+            if (delta & bit) {
+                cooked[row] ^= bit;
+                *left           = window(*a);
+                counters_active = true;
+                cooked_changed  = true;
+            }
+        }
+    }
+    profiler_end(PROF_DEBOUNCE, start);
+    return cooked_changed;
+}
+
+void debounce_free(void) {}
@@ -76,3 +76,13 @@
 #define MOUSEKEY_WHEEL_TIME_TO_MAX 40
 
 
+
+/* Learn the KCCF_1/KCGF_1 terms from observed press durations */
+#define TH_ADAPTIVE_TERM
+
+/* Learned terms, one uint16_t per tap-hold slot */
+#define EECONFIG_USER_DATA_SIZE 32
+
+/* Encoder detents are queued by users/muge/knob.c, no need to wait between press and release */
+#undef ENCODER_MAP_KEY_DELAY
+#define ENCODER_MAP_KEY_DELAY 0
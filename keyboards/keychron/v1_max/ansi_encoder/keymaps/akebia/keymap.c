@@ -16,11 +16,11 @@
 
 #include QMK_KEYBOARD_H
 #include "keychron_common.h"
+#include "muge.h"
 
 #define TAP_TIME_KCAF_1 100
 #define TAP_TIME_KCCF_1 115
 #define TAP_TIME_KCGF_1 135
-#define TAP_HOLD_RETU_1 1000
 
 enum layers {
     MAC_BASE,
@@ -36,6 +36,10 @@ enum custom_keycodes {
     KCGF_1, // custom keycode. KC_GRV on tap, layer 4 on hold
 };
 
+#define TH_FIRST KCCF_1
+#define TH_LAST KCGF_1
+#define TH_COUNT (TH_LAST - TH_FIRST + 1)
+
 //#define KCCF_1 LT(L1,KC_CAPS) // required for the shorter tap.count method
 
 
@@ -102,12 +106,39 @@ const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][2] = {
 };
 #endif // ENCODER_MAP_ENABLE
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+// Volume speeds up on fast turns. See users/muge/knob.h.
+// clang-format off
+const knob_curve_t PROGMEM knob_curves[][NUM_ENCODERS] = {
+    [MAC_BASE] = {KNOB_CURVE(40, 4)},
+    [MAC_FN]   = {KNOB_NONE},
+    [WIN_BASE] = {KNOB_CURVE(40, 4)},
+    [KCW_1]    = {KNOB_NONE},
+    [L1]       = {KNOB_CURVE(40, 4)},
+    [L1_5]     = {KNOB_CURVE(40, 4)},
+};
+// clang-format on
+const uint8_t knob_curve_layers = ARRAY_SIZE(knob_curves);
+
+// Layer while held, tap keycode on a short press. See users/muge/tap_hold.h.
+// clang-format off
+const th_key_t PROGMEM th_keys[TH_COUNT] = {
+    [KCCF_1 - TH_FIRST] = TAP_HOLD_LAYER(KC_CAPS, L1,   0,                 TAP_TIME_KCCF_1),
+    [KCGF_1 - TH_FIRST] = TAP_HOLD_LAYER(KC_GRV,  L1_5, MOD_BIT(KC_LCTL), TAP_TIME_KCGF_1),
+};
+// clang-format on
+
+const uint8_t th_key_count = TH_COUNT;
+
+bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
     if (!process_record_keychron_common(keycode, record)) {
         return false;
     }
     //return true;
 
+    if (keycode >= TH_FIRST && keycode <= TH_LAST) {
+        return process_tap_hold(keycode - TH_FIRST, record);
+    }
+
     switch (keycode) {
         // case KCAF_1:
         //  static uint16_t caf_timer;
@@ -122,43 +153,6 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
         //         }
         //     }
         //     return false;
-
-        case KCCF_1:
-            // if (record->tap.count && record->event.pressed) {
-            //     tap_code16(KC_CAPS);
-            //     return false;
-            // }
-            //return true;
-            static uint16_t ccf_timer;
-            if (record->event.pressed) {
-                ccf_timer = timer_read();
-                layer_on(L1);
-            } else {
-                layer_off(L1);
-                if (timer_elapsed(ccf_timer) < TAP_TIME_KCCF_1) {
-                    tap_code16(KC_CAPS);
-                }
-            }
-            return false;
-
-
-        case KCGF_1:
-            static uint16_t cgf_timer;
-            if (record->event.pressed) {
-                cgf_timer = timer_read();
-                register_mods(MOD_BIT(KC_LCTL));
-                layer_on(L1_5);
-                if (timer_elapsed(cgf_timer) > TAP_HOLD_RETU_1) {
-                    tap_code16(KC_GRV);
-                }
-            } else {
-                layer_off(L1_5);
-                unregister_mods(MOD_BIT(KC_LCTL));
-                if (timer_elapsed(cgf_timer) < TAP_TIME_KCGF_1) {
-                    tap_code16(KC_GRV);
-                }
-            }
-            return true;
     }
 
     return true;
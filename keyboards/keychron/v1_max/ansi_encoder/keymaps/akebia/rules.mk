@@ -1 +1,7 @@
+USER_NAME := muge
+
 MOUSEKEY_ENABLE = yes
+MUGE_KNOB_ENABLE = yes
+MUGE_TAP_HOLD_ENABLE = yes
+MUGE_KEY_TRACE_ENABLE = yes
+MUGE_SCAN_STATS_ENABLE = yes
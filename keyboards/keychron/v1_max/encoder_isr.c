@@ -0,0 +1,144 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Interrupt-driven quadrature decoding for the knob.
+ *
+ * Both encoder pins raise a PAL event on every edge. The callback runs in
+ * the EXTI interrupt, decodes the transition with the usual quadrature
+ * table and pushes each full detent into a single-producer/single-consumer
+ * ring. encoder_driver_task() drains the ring from the main loop, so steps
+ * made while the loop is busy with RGB or the wireless module are kept.
+ *
+ * ENCODER_RESOLUTIONS, ENCODER_DIRECTION_FLIP and ENCODER_DEFAULT_POS mean
+ * the same as for quantum/encoder/encoder_quadrature.c.
+ */
+
+#include "quantum.h"
+#include "encoder.h"
+
+#if !defined(ENCODER_A_PINS) && defined(ENCODERS_PAD_A)
+#    define ENCODER_A_PINS ENCODERS_PAD_A
+#    define ENCODER_B_PINS ENCODERS_PAD_B
+#endif
+
+#ifndef ENCODER_RESOLUTION
+#    define ENCODER_RESOLUTION 4
+#endif
+
+#ifndef ENCODER_DIRECTION_FLIP
+#    define ENCODER_CLOCKWISE true
+#    define ENCODER_COUNTER_CLOCKWISE false
+#else
+#    define ENCODER_CLOCKWISE false
+#    define ENCODER_COUNTER_CLOCKWISE true
+#endif
+
+#ifndef ENCODER_ISR_QUEUE
+#    define ENCODER_ISR_QUEUE 32 // detents, power of two
+#endif
+
+_Static_assert((ENCODER_ISR_QUEUE & (ENCODER_ISR_QUEUE - 1)) == 0, "ENCODER_ISR_QUEUE must be a power of two");
+
+static const pin_t encoder_a_pins[] = ENCODER_A_PINS;
+static const pin_t encoder_b_pins[] = ENCODER_B_PINS;
+
+static const int8_t encoder_lut[] = {0, -1, 1, 0, 1, 0, 0, -1, -1, 0, 0, 1, 0, 1, -1, 0};
+
+#ifdef ENCODER_RESOLUTIONS
+static const uint8_t encoder_resolutions[NUM_ENCODERS] = ENCODER_RESOLUTIONS;
+#    define ENCODER_RESOLUTION_OF(index) encoder_resolutions[index]
+#else
+#    define ENCODER_RESOLUTION_OF(index) ENCODER_RESOLUTION
+#endif
+
+static uint8_t encoder_state[NUM_ENCODERS];
+static int8_t  encoder_pulses[NUM_ENCODERS];
+
+// bit 0 clockwise, bits 1.. encoder index; head is only written by the ISR, tail only by the loop
+static uint8_t          encoder_queue[ENCODER_ISR_QUEUE];
+static volatile uint8_t encoder_head;
+static volatile uint8_t encoder_tail;
+
+static void encoder_push(uint8_t index, bool clockwise) {
+    uint8_t head = encoder_head;
+    uint8_t next = (head + 1) & (ENCODER_ISR_QUEUE - 1);
+
+    // a full ring drops the detent, the loop is far behind anyway
+    if (next == encoder_tail) {
+        return;
+    }
+    encoder_queue[head] = index << 1 | clockwise;
+    __DMB();
+    encoder_head = next;
+}
+
+static uint8_t encoder_read(uint8_t index) {
+    return palReadLine(encoder_a_pins[index]) | palReadLine(encoder_b_pins[index]) << 1;
+}
+
+static void encoder_edge_cb(void *arg) {
+    uint8_t index      = (uintptr_t)arg;
+    int8_t  resolution = ENCODER_RESOLUTION_OF(index);
+
+    encoder_state[index] = (encoder_state[index] << 2 | encoder_read(index)) & 0xF;
+    encoder_pulses[index] += encoder_lut[encoder_state[index]];
+#ifdef ENCODER_DEFAULT_POS
+    // back at the detent: any partial step counts, and the count starts over
+    if ((encoder_state[index] & 0x3) == ENCODER_DEFAULT_POS) {
+        if (encoder_pulses[index] >= 1) {
+            encoder_push(index, ENCODER_COUNTER_CLOCKWISE);
+        } else if (encoder_pulses[index] <= -1) {
+            encoder_push(index, ENCODER_CLOCKWISE);
+        }
+        encoder_pulses[index] = 0;
+        return;
+    }
+#endif
+    if (encoder_pulses[index] >= resolution) {
+        encoder_push(index, ENCODER_COUNTER_CLOCKWISE);
+    } else if (encoder_pulses[index] <= -resolution) {
+        encoder_push(index, ENCODER_CLOCKWISE);
+    }
+    encoder_pulses[index] %= resolution;
+}
+
+void encoder_driver_init(void) {
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        gpio_set_pin_input_high(encoder_a_pins[i]);
+        gpio_set_pin_input_high(encoder_b_pins[i]);
+    }
+    // let the pull-ups settle before taking the resting state
+    wait_us(100);
+
+    for (uint8_t i = 0; i < NUM_ENCODERS; i++) {
+        encoder_state[i]  = encoder_read(i);
+        encoder_pulses[i] = 0;
+
+        // an EXTI line armed elsewhere, e.g. as a wake-up source, must be
+        // released before it can be armed again
+        palDisableLineEvent(encoder_a_pins[i]);
+        palDisableLineEvent(encoder_b_pins[i]);
+        palEnableLineEvent(encoder_a_pins[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoder_a_pins[i], encoder_edge_cb, (void *)(uintptr_t)i);
+        palEnableLineEvent(encoder_b_pins[i], PAL_EVENT_MODE_BOTH_EDGES);
+        palSetLineCallback(encoder_b_pins[i], encoder_edge_cb, (void *)(uintptr_t)i);
+    }
+}
+
+// The Keychron low-power code re-arms the knob with encoder_cb_init() when
+// it leaves STOP mode, after using the lines as wake-up sources. The call is
+// wrapped (see rules.mk) so it puts this driver's callbacks back instead of
+// the stock ones.
+void __wrap_encoder_cb_init(void) {
+    encoder_driver_init();
+}
+
+void encoder_driver_task(void) {
+    while (encoder_tail != encoder_head) {
+        __DMB();
+        uint8_t entry = encoder_queue[encoder_tail];
+
+        encoder_tail = (encoder_tail + 1) & (ENCODER_ISR_QUEUE - 1);
+        encoder_queue_event(entry >> 1, entry & 1);
+    }
+}
@@ -0,0 +1,224 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "led_flush.h"
+#include "snled27351-spi.h"
+#include "spi_master.h"
+#include "profiler.h"
+
+#ifndef SNLED27351_PWM_REGISTER_COUNT
+#    define SNLED27351_PWM_REGISTER_COUNT 192
+#endif
+#ifndef SNLED23751_SPI_DIVISOR
+#    define SNLED23751_SPI_DIVISOR 16
+#endif
+// spi_start() and snled27351_*() are wrapped, see post_rules.mk
+#ifdef LTO_ENABLE
+#    error "led_flush.c needs LTO_ENABLE = no, LTO bypasses its --wrap wrappers"
+#endif
+#ifndef SPI_DRIVER
+#    error "led_flush.c drives the SPI the LED chips are on, set SPI_DRIVER in config.h"
+#endif
+#ifndef LED_FLUSH_TIMEOUT
+#    define LED_FLUSH_TIMEOUT 20 // ms; a full frame of both chips takes ~1.2 ms
+#endif
+
+#define PAGE_PWM 0x01
+#define CMD_WRITE(page) (0x20 | (page)) // write, chip ID 2, page
+#define CHUNKS (SNLED27351_PWM_REGISTER_COUNT / LED_FLUSH_CHUNK)
+#define ALL_CHUNKS ((1UL << CHUNKS) - 1)
+
+_Static_assert(SNLED27351_PWM_REGISTER_COUNT % LED_FLUSH_CHUNK == 0, "LED_FLUSH_CHUNK must divide the PWM page");
+_Static_assert(CHUNKS < 32, "LED_FLUSH_CHUNK too small for a 32-bit dirty mask");
+
+static const pin_t cs_pins[DRIVER_COUNT] = DRIVER_CS_PINS;
+
+// one SPI transaction: command, register and PWM data, contiguous in tx[]
+typedef struct {
+    pin_t    cs;
+    uint8_t *buf;
+    uint16_t len;
+} segment_t;
+
+static void end_cb(SPIDriver *spip);
+
+static const SPIConfig spi_config = {
+    .end_cb = end_cb,
+    // mode 0, MSB first, PCLK / SNLED23751_SPI_DIVISOR
+    .cr1 = (__builtin_ctz(SNLED23751_SPI_DIVISOR) - 1) << SPI_CR1_BR_Pos,
+};
+
+static uint8_t  pwm[DRIVER_COUNT][SNLED27351_PWM_REGISTER_COUNT]; // rendered into
+static uint32_t dirty[DRIVER_COUNT];
+
+// Staged copy streamed by DMA while the next frame renders into pwm[]. A
+// run takes at least one chunk, so each header pair is paid for by one.
+static uint8_t          tx[DRIVER_COUNT * (SNLED27351_PWM_REGISTER_COUNT + 2 * CHUNKS)];
+static segment_t        segments[DRIVER_COUNT * CHUNKS];
+static uint8_t          segment_count;
+static volatile uint8_t segment_next;
+static volatile bool    busy;
+static uint16_t         busy_since;
+static uint32_t         bytes;
+static uint32_t         bytes_per_sec;
+static uint32_t         second_timer;
+
+/* The stock snled27351_spi driver stays the RGB matrix driver; its entry
+ * points are wrapped at link time, see post_rules.mk. Colours only update
+ * the mirror, and the wrapped flush sends it.
+ */
+void __real_snled27351_init_drivers(void);
+
+void __wrap_snled27351_init_drivers(void) {
+    // the stock init leaves every PWM register at zero, as is the mirror
+    led_flush_wait();
+    __real_snled27351_init_drivers();
+    memset(pwm, 0, sizeof(pwm));
+    memset(dirty, 0, sizeof(dirty));
+    second_timer = timer_read32();
+}
+
+static inline void set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (pwm[driver][reg] != value) {
+        pwm[driver][reg] = value;
+        dirty[driver] |= 1UL << (reg / LED_FLUSH_CHUNK);
+    }
+}
+
+void __wrap_snled27351_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    snled27351_led_t led;
+
+    if (index < 0 || index >= SNLED27351_LED_COUNT) {
+        return;
+    }
+    memcpy_P(&led, &g_snled27351_leds[index], sizeof(led));
+    set_pwm(led.driver, led.r, red);
+    set_pwm(led.driver, led.g, green);
+    set_pwm(led.driver, led.b, blue);
+}
+
+void __wrap_snled27351_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {
+    for (int i = 0; i < SNLED27351_LED_COUNT; i++) {
+        __wrap_snled27351_set_color(i, red, green, blue);
+    }
+}
+
+// SPI interrupt: release the finished segment and chain the next one
+static void end_cb(SPIDriver *spip) {
+    palSetLine(segments[segment_next].cs);
+    if (++segment_next < segment_count) {
+        segment_t *seg = &segments[segment_next];
+
+        palClearLine(seg->cs);
+        osalSysLockFromISR();
+        spiStartSendI(spip, seg->len, seg->buf);
+        osalSysUnlockFromISR();
+    } else {
+        busy = false;
+    }
+}
+
+static uint8_t *stage_run(uint8_t *out, uint8_t driver, uint8_t reg, uint8_t len) {
+    segment_t *seg = &segments[segment_count++];
+
+    seg->cs  = cs_pins[driver];
+    seg->buf = out;
+    seg->len = 2 + len;
+    *out++   = CMD_WRITE(PAGE_PWM);
+    *out++   = reg;
+    memcpy(out, &pwm[driver][reg], len);
+    bytes += seg->len;
+    return out + len;
+}
+
+// Gives up on a transfer that never completed: stops the DMA, releases the
+// chips and sends the whole mirror with the next flush.
+static void flush_abort(void) {
+    spiAbort(&SPI_DRIVER);
+    for (uint8_t driver = 0; driver < DRIVER_COUNT; driver++) {
+        palSetLine(cs_pins[driver]);
+        dirty[driver] = ALL_CHUNKS;
+    }
+    busy = false;
+}
+
+static bool flush_timed_out(void) {
+    return busy && timer_elapsed(busy_since) >= LED_FLUSH_TIMEOUT;
+}
+
+static void flush_start(void) {
+    uint8_t *out = tx;
+
+    segment_count = 0;
+    for (uint8_t driver = 0; driver < DRIVER_COUNT; driver++) {
+        uint32_t mask = dirty[driver];
+
+        dirty[driver] = 0;
+        while (mask) {
+            uint8_t first = __builtin_ctz(mask);
+            uint8_t run   = __builtin_ctz(~(mask >> first));
+
+            out = stage_run(out, driver, first * LED_FLUSH_CHUNK, run * LED_FLUSH_CHUNK);
+            mask &= ~(((1UL << run) - 1) << first);
+        }
+    }
+    if (segment_count) {
+        busy         = true;
+        busy_since   = timer_read();
+        segment_next = 0;
+        spiStart(&SPI_DRIVER, &spi_config);
+        palClearLine(segments[0].cs);
+        spiStartSend(&SPI_DRIVER, segments[0].len, segments[0].buf);
+    }
+}
+
+void __wrap_snled27351_flush(void) {
+    uint32_t start = profiler_begin();
+
+    if (timer_elapsed32(second_timer) >= 1000) {
+        bytes_per_sec = bytes;
+        bytes         = 0;
+        second_timer  = timer_read32();
+    }
+    if (flush_timed_out()) {
+        flush_abort();
+    }
+    // still streaming the previous frame: its dirty bits carry over
+    if (!busy) {
+        flush_start();
+    }
+    profiler_end(PROF_FLUSH, start);
+}
+
+void led_flush_wait(void) {
+    while (busy) {
+        if (flush_timed_out()) {
+            flush_abort();
+        }
+    }
+}
+
+/* Every other user of the bus (the stock driver, the wireless module)
+ * goes through spi_start(), wrapped at link time to let a transfer in
+ * flight finish first.
+ */
+bool __real_spi_start(pin_t slave_pin, bool lsb_first, uint8_t mode, uint16_t divisor);
+
+bool __wrap_spi_start(pin_t slave_pin, bool lsb_first, uint8_t mode, uint16_t divisor) {
+    led_flush_wait();
+    return __real_spi_start(slave_pin, lsb_first, mode, divisor);
+}
+
+void __real_snled27351_exit_shutdown(void);
+
+void __wrap_snled27351_exit_shutdown(void) {
+    __real_snled27351_exit_shutdown();
+    // the chips may have lost their PWM page, send the whole mirror again
+    for (uint8_t driver = 0; driver < DRIVER_COUNT; driver++) {
+        dirty[driver] = ALL_CHUNKS;
+    }
+}
+
+uint32_t led_flush_bytes_per_sec(void) {
+    return bytes_per_sec;
+}
@@ -0,0 +1,37 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* PWM flush for the two SNLED27351 chips that only sends what changed.
+ *
+ * The PWM page is mirrored in RAM and split into LED_FLUSH_CHUNK-byte chunks.
+ * snled27351_set_color() marks a chunk dirty only when a value actually
+ * changes, and snled27351_flush() writes each run of dirty chunks in a single
+ * SPI transaction. A static effect costs no bus time at all; an indicator
+ * touches one chunk.
+ *
+ * The flush only stages the runs into a second buffer and starts the first
+ * one with spiStartSend(); the SPI interrupt chains the rest, so the main
+ * loop never waits on the LEDs. A flush that finds the previous frame
+ * still streaming leaves its dirty bits for the next one. A transfer still
+ * running after LED_FLUSH_TIMEOUT ms is aborted, and the whole mirror is
+ * sent again.
+ *
+ * The keyboard keeps QMK's snled27351_spi RGB matrix driver. Its set_color,
+ * set_color_all, flush, init and exit_shutdown functions are wrapped at link
+ * time; chip setup, the LED control page and shutdown stay with it.
+ */
+
+#ifndef LED_FLUSH_CHUNK
+#    define LED_FLUSH_CHUNK 16 // PWM registers per dirty bit
+#endif
+
+// Block until the DMA transfer in flight, if any, has finished, or abort it
+// after LED_FLUSH_TIMEOUT ms.
+void led_flush_wait(void);
+
+// Bytes clocked out to the LED drivers over the last full second.
+uint32_t led_flush_bytes_per_sec(void);
@@ -0,0 +1,161 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Port-parallel matrix scan for the V1 Max.
+ *
+ * The matrix is ROW2COL: each of the 16 columns is driven low in turn and
+ * the 6 rows are read. Columns are open-drain outputs switched through
+ * BSRR. The rows are read with one IDR access per GPIO port (C, D and B).
+ * The row bits of each word are XORed against the same column's words from
+ * the previous scan; when none differ the scan returns false straight away,
+ * and only a changed scan is unpacked into matrix rows through the port and
+ * bit of each row worked out at init.
+ *
+ * Instead of a fixed MATRIX_IO_DELAY after every column, the scan waits
+ * only after a column that saw a key down. It polls until all rows read
+ * high again, and gives up after MATRIX_IO_DELAY us.
+ *
+ * Driving a column low needs no such wait: the open-drain output sinks the
+ * rows hard, and only the input synchroniser (two HCLK cycles) stands
+ * between the BSRR write and the IDR read. Comparing the previous column's
+ * words in that gap covers it, so waitInputPinDelay() runs once per scan, before the
+ * first column, instead of after each of the 16.
+ */
+
+#include "quantum.h"
+#include "matrix.h"
+#include "profiler.h"
+#ifdef MUGE_SCAN_STATS_ENABLE
+#    include "scan_stats.h"
+#endif
+
+// not static, the wireless low-power code wakes on these pins
+pin_t row_pins[MATRIX_ROWS] = MATRIX_ROW_PINS;
+pin_t col_pins[MATRIX_COLS] = MATRIX_COL_PINS;
+
+static ioportid_t   row_ports[MATRIX_ROWS];
+static ioportmask_t row_port_masks[MATRIX_ROWS]; // every row bit on that port
+static uint8_t      row_port_count;
+static uint8_t      row_port_index[MATRIX_ROWS];
+static ioportmask_t row_bit[MATRIX_ROWS];
+static ioportmask_t last_words[MATRIX_COLS][MATRIX_ROWS]; // row bits only
+
+static void read_row_ports(ioportmask_t idr[]) {
+    for (uint8_t p = 0; p < row_port_count; p++) {
+        idr[p] = palReadPort(row_ports[p]);
+    }
+}
+
+static bool rows_high(const ioportmask_t idr[]) {
+    for (uint8_t p = 0; p < row_port_count; p++) {
+        if ((idr[p] & row_port_masks[p]) != row_port_masks[p]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool rows_released(void) {
+    ioportmask_t idr[MATRIX_ROWS];
+
+    read_row_ports(idr);
+    return rows_high(idr);
+}
+
+// Stores the column's row bits and returns those that changed.
+static ioportmask_t fold_column(const ioportmask_t idr[], uint8_t col) {
+    ioportmask_t diff = 0;
+
+    for (uint8_t p = 0; p < row_port_count; p++) {
+        ioportmask_t word = idr[p] & row_port_masks[p];
+
+        diff |= word ^ last_words[col][p];
+        last_words[col][p] = word;
+    }
+    return diff;
+}
+
+static void unpack_column(matrix_row_t next[], const ioportmask_t idr[], uint8_t col) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (!(idr[row_port_index[row]] & row_bit[row])) {
+            next[row] |= MATRIX_ROW_SHIFTER << col;
+        }
+    }
+}
+
+// Waits for the rows to float back up after a column with a key down.
+static void wait_rows_released(void) {
+    rtcnt_t start = chSysGetRealtimeCounterX();
+    rtcnt_t end   = start + US2RTC(STM32_HCLK, MATRIX_IO_DELAY);
+
+    while (!rows_released() && chSysIsCounterWithinX(chSysGetRealtimeCounterX(), start, end)) {
+    }
+}
+
+void matrix_init_custom(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        ioportid_t port = PAL_PORT(row_pins[row]);
+        uint8_t    p    = 0;
+
+        palSetLineMode(row_pins[row], PAL_MODE_INPUT_PULLUP);
+        while (p < row_port_count && row_ports[p] != port) {
+            p++;
+        }
+        if (p == row_port_count) {
+            row_ports[row_port_count++] = port;
+        }
+        row_port_index[row] = p;
+        row_bit[row]        = PAL_PORT_BIT(PAL_PAD(row_pins[row]));
+        row_port_masks[p] |= row_bit[row];
+    }
+    // all rows high, the empty matrix QMK starts with
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        memcpy(last_words[col], row_port_masks, sizeof(row_port_masks));
+    }
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        palSetLine(col_pins[col]);
+        palSetLineMode(col_pins[col], PAL_MODE_OUTPUT_OPENDRAIN | PAL_STM32_PUPDR_PULLUP);
+    }
+}
+
+bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    uint32_t     start             = profiler_begin();
+    ioportmask_t idr[MATRIX_ROWS];
+    ioportmask_t diff = 0;
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        palClearLine(col_pins[col]);
+        // idr still holds the previous column
+        if (col) {
+            diff |= fold_column(idr, col - 1);
+        } else {
+            waitInputPinDelay();
+        }
+        read_row_ports(idr);
+        palSetLine(col_pins[col]);
+
+        if (!rows_high(idr)) {
+            wait_rows_released();
+        }
+    }
+    diff |= fold_column(idr, MATRIX_COLS - 1);
+
+#ifdef MUGE_SCAN_STATS_ENABLE
+    scan_stats_record(!diff);
+#endif
+    // current_matrix is what the stored words unpacked to last time
+    if (!diff) {
+        profiler_end(PROF_MATRIX, start);
+        return false;
+    }
+
+    matrix_row_t next[MATRIX_ROWS] = {0};
+
+    for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+        unpack_column(next, last_words[col], col);
+    }
+    memcpy(current_matrix, next, sizeof(next));
+    profiler_end(PROF_MATRIX, start);
+    return true;
+}
@@ -0,0 +1,30 @@
+# The board code takes over QMK and Keychron functions with --wrap, here and
+# in rules.mk. A call that LTO has resolved inside its unit never reaches the
+# wrapper, so LTO stays off whatever the Keychron common rules or a keymap set.
+LTO_ENABLE = no
+
+# Dirty-chunk PWM flush for the stock snled27351_spi driver, see led_flush.h.
+ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
+    SRC += led_flush.c
+    EXTRALDFLAGS += -Wl,--wrap=snled27351_init_drivers -Wl,--wrap=snled27351_exit_shutdown
+    EXTRALDFLAGS += -Wl,--wrap=snled27351_set_color -Wl,--wrap=snled27351_set_color_all
+    EXTRALDFLAGS += -Wl,--wrap=snled27351_flush
+    # other bus users wait out the LED DMA transfer
+    EXTRALDFLAGS += -Wl,--wrap=spi_start
+endif
+
+# Scan-loop profiler, see profiler.h. Checked here so keymaps can enable it.
+ifeq ($(strip $(SCAN_PROFILER_ENABLE)), yes)
+    SRC += profiler.c
+    OPT_DEFS += -DSCAN_PROFILER_ENABLE
+    # the statistics are read over raw HID
+    RAW_ENABLE = yes
+    EXTRALDFLAGS += -Wl,--wrap=host_keyboard_send -Wl,--wrap=process_record_quantum
+    EXTRALDFLAGS += -Wl,--wrap=raw_hid_receive
+    # this build's __wrap_raw_hid_receive() is the profiler's, it hands
+    # reports on to raw_hid_intercept_user() before raw_hid_receive()
+    OPT_DEFS += -DRAW_HID_INTERCEPT_KB
+    ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
+        EXTRALDFLAGS += -Wl,--wrap=rgb_matrix_task
+    endif
+endif
@@ -0,0 +1,133 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "profiler.h"
+#include "raw_hid.h"
+#ifdef RGB_MATRIX_ENABLE
+#    include "led_flush.h"
+#endif
+
+#define CYCLES_PER_US (CPU_CLOCK / 1000000)
+
+typedef struct __attribute__((packed)) {
+    uint32_t min; // cycles
+    uint32_t max; // cycles
+    uint32_t count;
+    uint16_t hist[PROFILER_BUCKETS];
+} profiler_stats_t;
+
+_Static_assert(2 + sizeof(profiler_stats_t) <= RAW_EPSIZE, "phase statistics must fit one raw HID report");
+
+static profiler_stats_t stats[PROF_PHASES];
+
+static void profiler_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    for (uint8_t i = 0; i < PROF_PHASES; i++) {
+        stats[i].min = UINT32_MAX;
+    }
+}
+
+void profiler_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+    profiler_reset();
+}
+
+uint32_t profiler_begin(void) {
+    return DWT->CYCCNT;
+}
+
+void profiler_end(uint8_t phase, uint32_t start) {
+    profiler_stats_t *s      = &stats[phase];
+    uint32_t          cycles = DWT->CYCCNT - start;
+    uint32_t          us     = cycles / CYCLES_PER_US;
+    uint8_t           bucket = 0;
+
+    while (us && bucket < PROFILER_BUCKETS - 1) {
+        us >>= 1;
+        bucket++;
+    }
+    s->min = MIN(s->min, cycles);
+    s->max = MAX(s->max, cycles);
+    s->count++;
+    if (s->hist[bucket] < UINT16_MAX) {
+        s->hist[bucket]++;
+    }
+}
+
+static bool profiler_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+        case PROFILER_CMD_GET:
+            if (data[1] >= PROF_PHASES) {
+                return false;
+            }
+            memcpy(&data[2], &stats[data[1]], sizeof(profiler_stats_t));
+            break;
+        case PROFILER_CMD_RESET:
+            profiler_reset();
+            break;
+#ifdef RGB_MATRIX_ENABLE
+        case PROFILER_CMD_LED_BPS: {
+            uint32_t bps = led_flush_bytes_per_sec();
+
+            memcpy(&data[1], &bps, sizeof(bps));
+            break;
+        }
+#endif
+        default:
+            return false;
+    }
+    raw_hid_send(data, length);
+    return true;
+}
+
+/* The phases inside QMK are timed by wrapping their entry points at link
+ * time, see post_rules.mk. Only calls from other translation units go
+ * through the wrappers, which is how the loop reaches all of them.
+ */
+
+// action.c calls into quantum.c; the span starts and ends in this call
+bool __real_process_record_quantum(keyrecord_t *record);
+
+bool __wrap_process_record_quantum(keyrecord_t *record) {
+    uint32_t start = profiler_begin();
+    bool     ret   = __real_process_record_quantum(record);
+
+    profiler_end(PROF_RECORD, start);
+    return ret;
+}
+
+// Profiler reports are taken before whichever of VIA, the Keychron common
+// code or a userspace owns raw_hid_receive(), so no hook has to forward them.
+// A userspace that intercepts reports the same way gets them next.
+__attribute__((weak)) bool raw_hid_intercept_user(uint8_t *data, uint8_t length) {
+    return false;
+}
+
+void __real_raw_hid_receive(uint8_t *data, uint8_t length);
+
+void __wrap_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (!profiler_raw_hid(data, length) && !raw_hid_intercept_user(data, length)) {
+        __real_raw_hid_receive(data, length);
+    }
+}
+
+#ifdef RGB_MATRIX_ENABLE
+void __real_rgb_matrix_task(void);
+
+void __wrap_rgb_matrix_task(void) {
+    uint32_t start = profiler_begin();
+
+    __real_rgb_matrix_task();
+    profiler_end(PROF_RGB, start);
+}
+#endif
+
+void __real_host_keyboard_send(report_keyboard_t *report);
+
+void __wrap_host_keyboard_send(report_keyboard_t *report) {
+    uint32_t start = profiler_begin();
+
+    __real_host_keyboard_send(report);
+    profiler_end(PROF_SEND, start);
+}
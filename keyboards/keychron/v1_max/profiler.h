@@ -0,0 +1,50 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Scan-loop profiler, built with SCAN_PROFILER_ENABLE = yes.
+ *
+ * Each phase of the loop is timed with the DWT cycle counter and folded
+ * into a min/max/count and a histogram of power-of-two microsecond buckets.
+ * A raw HID report starting with PROFILER_CMD_GET and a phase number is
+ * answered with that phase's statistics. PROFILER_CMD_RESET clears them
+ * all. PROFILER_CMD_LED_BPS returns the LED drivers' SPI bytes per second.
+ * These reports are answered before raw_hid_receive() sees them; every
+ * other report goes on to it unchanged.
+ *
+ * Without SCAN_PROFILER_ENABLE the calls below compile to nothing.
+ */
+
+#define PROFILER_CMD_GET 0xE8
+#define PROFILER_CMD_RESET 0xE9
+#define PROFILER_CMD_LED_BPS 0xEA
+
+#define PROFILER_BUCKETS 9 // <1, <2, <4 ... <128, >=128 us
+
+enum profiler_phase {
+    PROF_MATRIX,
+    PROF_DEBOUNCE,
+    PROF_RECORD, // process_record_quantum(), keycode handlers and keymap
+    PROF_KEYCHRON_TASK,
+    PROF_RGB, // whole rgb_matrix_task(), flush included
+    PROF_FLUSH,
+    PROF_SEND,
+    PROF_PHASES,
+};
+
+#ifdef SCAN_PROFILER_ENABLE
+void     profiler_init(void);
+uint32_t profiler_begin(void);
+void     profiler_end(uint8_t phase, uint32_t start);
+#else
+static inline void profiler_init(void) {}
+
+static inline uint32_t profiler_begin(void) {
+    return 0;
+}
+
+static inline void profiler_end(uint8_t phase, uint32_t start) {}
+#endif
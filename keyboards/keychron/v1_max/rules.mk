@@ -2,3 +2,16 @@ include keyboards/keychron/common/wireless/wireless.mk
 include keyboards/keychron/common/keychron_common.mk
 
 VPATH += $(TOP_DIR)/keyboards/keychron
+
+# knob edges are decoded in the PAL interrupt, see encoder_isr.c
+ENCODER_DRIVER = custom
+SRC += encoder_isr.c
+# Keychron's wake-up path re-arms the knob through encoder_cb_init()
+EXTRALDFLAGS += -Wl,--wrap=encoder_cb_init
+
+# rows are read a whole GPIO port at a time, see matrix.c
+CUSTOM_MATRIX = lite
+SRC += matrix.c
+
+# per-key adaptive eager debounce, see adaptive_debounce.c
+SRC += adaptive_debounce.c
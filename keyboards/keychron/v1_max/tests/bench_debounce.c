@@ -0,0 +1,234 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+/* Feeds the same bounce traces to QMK's sym_defer_g, sym_eager_pk and
+ * asym_eager_defer_pk and to adaptive_debounce.c, and prints the latency
+ * each adds over the ideal key edges and the events it reports that the
+ * ideal key did not.
+ *
+ * The three QMK algorithms are reduced to the rules of
+ * quantum/debounce/ that decide when cooked changes; their bookkeeping
+ * for skipping idle scans is left out. Every algorithm gets a scan every
+ * SCAN_US microseconds and a millisecond timer, as on the board. The trace
+ * edges fall on scans, so the latencies are what the debounce adds and not
+ * the scan interval.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "adaptive_debounce.c"
+
+#define SCAN_US 250
+#define REPEAT 50 // keystrokes per trace, so the adaptive windows can settle
+
+fast_timer_t test_now;
+
+/* sym_defer_g: cooked follows raw once no key changed for DEBOUNCE ms. */
+
+static bool         defer_g_pending;
+static fast_timer_t defer_g_time;
+
+static void defer_g_init(void) {
+    defer_g_pending = false;
+}
+
+static bool defer_g(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+
+    if (changed) {
+        defer_g_pending = true;
+        defer_g_time    = timer_read_fast();
+    } else if (defer_g_pending && TIMER_DIFF_FAST(timer_read_fast(), defer_g_time) >= DEBOUNCE) {
+        for (uint8_t row = 0; row < num_rows; row++) {
+            cooked_changed |= cooked[row] != raw[row];
+            cooked[row] = raw[row];
+        }
+        defer_g_pending = false;
+    }
+    return cooked_changed;
+}
+
+/* sym_eager_pk and asym_eager_defer_pk: a per-key countdown in ms. */
+
+static uint8_t      pk_time[MATRIX_ROWS][MATRIX_COLS];
+static bool         pk_pressed[MATRIX_ROWS][MATRIX_COLS];
+static fast_timer_t pk_last;
+
+static void pk_init(void) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            pk_time[row][col] = 0;
+        }
+    }
+    pk_last = timer_read_fast();
+}
+
+static uint8_t pk_elapsed(void) {
+    fast_timer_t now     = timer_read_fast();
+    uint8_t      elapsed = MIN(TIMER_DIFF_FAST(now, pk_last), UINT8_MAX);
+
+    pk_last = now;
+    return elapsed;
+}
+
+// A change is reported at once, then the key is locked for DEBOUNCE ms.
+static bool eager_pk(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint8_t elapsed        = pk_elapsed();
+    bool    cooked_changed = false;
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t bit  = MATRIX_ROW_SHIFTER << col;
+            uint8_t     *time = &pk_time[row][col];
+
+            *time = *time > elapsed ? *time - elapsed : 0;
+            if (!*time && ((raw[row] ^ cooked[row]) & bit)) {
+                cooked[row] ^= bit;
+                *time          = DEBOUNCE;
+                cooked_changed = true;
+            }
+        }
+    }
+    return cooked_changed;
+}
+
+// Presses as eager_pk. A release is reported once the key has read released
+// for DEBOUNCE ms; reading pressed again in between cancels it.
+static bool eager_defer_pk(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    uint8_t elapsed        = pk_elapsed();
+    bool    cooked_changed = false;
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            matrix_row_t bit     = MATRIX_ROW_SHIFTER << col;
+            uint8_t     *time    = &pk_time[row][col];
+            bool        *pressed = &pk_pressed[row][col];
+
+            if (*time) {
+                if (*time > elapsed) {
+                    *time -= elapsed;
+                } else {
+                    *time = 0;
+                    if (!*pressed && ((raw[row] ^ cooked[row]) & bit)) {
+                        cooked[row] ^= bit;
+                        cooked_changed = true;
+                    }
+                }
+            }
+            if ((raw[row] ^ cooked[row]) & bit) {
+                if (!*time) {
+                    *pressed = raw[row] & bit;
+                    *time    = DEBOUNCE;
+                    if (*pressed) {
+                        cooked[row] ^= bit;
+                        cooked_changed = true;
+                    }
+                }
+            } else if (*time && !*pressed) {
+                *time = 0;
+            }
+        }
+    }
+    return cooked_changed;
+}
+
+static void adaptive_init(void) {
+    debounce_init(MATRIX_ROWS);
+    counters_active = false;
+}
+
+typedef struct {
+    const char *name;
+    void (*init)(void);
+    bool (*debounce)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+} algorithm_t;
+
+static const algorithm_t algorithms[] = {
+    {"sym_defer_g", defer_g_init, defer_g},
+    {"sym_eager_pk", pk_init, eager_pk},
+    {"asym_eager_defer_pk", pk_init, eager_defer_pk},
+    {"adaptive", adaptive_init, debounce},
+};
+
+/* One keystroke as the contacts see it: the raw level flips at each edge,
+ * starting released. press_us and release_us are where an ideal key would
+ * change; a trace with press_us == 0 is noise that should not be reported.
+ */
+typedef struct {
+    const char *name;
+    uint32_t    period_us;
+    uint32_t    press_us;
+    uint32_t    release_us;
+    uint32_t    edges_us[16];
+} trace_t;
+
+// clang-format off
+static const trace_t traces[] = {
+    {"clean",         60000,  1000, 31000, {1000, 31000}},
+    {"bounce 1 ms",   60000,  1000, 31000, {1000, 1300, 1500, 2000, 2200, 31000, 31400, 31700, 32000, 32200}},
+    {"bounce 3 ms",   60000,  1000, 31000, {1000, 1600, 2200, 3000, 4000, 31000, 31800, 32600, 33400, 34000}},
+    {"chatter",       60000,  1000, 31000, {1000, 7000, 7600, 31000}},
+    {"fast typing",   40000,  1000, 16000, {1000, 1300, 1500, 16000, 16300, 16600}},
+    {"noise spike",   60000,  0,    0,     {20000, 20250}},
+};
+// clang-format on
+
+typedef struct {
+    uint32_t press_us;
+    uint32_t release_us;
+    uint32_t measured;
+    uint32_t false_events;
+} result_t;
+
+static result_t run(const algorithm_t *algorithm, const trace_t *trace) {
+    result_t     result = {0};
+    matrix_row_t raw = 0, cooked = 0, last_raw = 0;
+    uint32_t     base = 0;
+
+    algorithm->init();
+    for (uint16_t n = 0; n < REPEAT; n++, base += trace->period_us) {
+        uint32_t changes[8];
+        uint8_t  count = 0;
+        uint8_t  edge  = 0;
+
+        for (uint32_t t = 0; t < trace->period_us; t += SCAN_US) {
+            while (edge < ARRAY_SIZE(trace->edges_us) && trace->edges_us[edge] && trace->edges_us[edge] <= t) {
+                raw ^= 1;
+                edge++;
+            }
+            test_now = (base + t) / 1000;
+            if (algorithm->debounce(&raw, &cooked, MATRIX_ROWS, raw != last_raw) && count < ARRAY_SIZE(changes)) {
+                changes[count++] = t;
+            }
+            last_raw = raw;
+        }
+
+        uint8_t expected = trace->press_us ? 2 : 0;
+
+        if (count == expected && expected) {
+            result.press_us += changes[0] - trace->press_us;
+            result.release_us += changes[1] - trace->release_us;
+            result.measured++;
+        }
+        result.false_events += abs(count - expected);
+    }
+    return result;
+}
+
+int main(void) {
+    printf("DEBOUNCE %d ms, scan every %d us, %d keystrokes per trace\n", DEBOUNCE, SCAN_US, REPEAT);
+    printf("%-12s %-20s %10s %10s %6s\n", "trace", "algorithm", "press us", "release us", "false");
+    for (uint8_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        for (uint8_t j = 0; j < ARRAY_SIZE(algorithms); j++) {
+            result_t r = run(&algorithms[j], &traces[i]);
+
+            if (r.measured) {
+                printf("%-12s %-20s %10lu %10lu %6lu\n", traces[i].name, algorithms[j].name, (unsigned long)(r.press_us / r.measured), (unsigned long)(r.release_us / r.measured), (unsigned long)r.false_events);
+            } else {
+                printf("%-12s %-20s %10s %10s %6lu\n", traces[i].name, algorithms[j].name, "-", "-", (unsigned long)r.false_events);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,30 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+// The parts of QMK's quantum.h that adaptive_debounce.c uses, for host tests.
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define MATRIX_ROWS 1
+#define MATRIX_COLS 2
+
+typedef uint8_t matrix_row_t;
+#define MATRIX_ROW_SHIFTER ((matrix_row_t)1)
+
+typedef uint32_t fast_timer_t;
+#define TIMER_DIFF_FAST(a, b) ((a) - (b))
+
+extern fast_timer_t test_now;
+
+static inline fast_timer_t timer_read_fast(void) {
+    return test_now;
+}
+
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+#ifndef MIN
+#    define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
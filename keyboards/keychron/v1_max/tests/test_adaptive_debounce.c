@@ -0,0 +1,174 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <stdio.h>
+
+#include "adaptive_debounce.c"
+
+fast_timer_t test_now;
+
+static matrix_row_t raw;
+static matrix_row_t cooked;
+static matrix_row_t last_raw;
+static int          failures;
+static int          tests;
+
+#define EXPECT(cond)                                                         \
+    do {                                                                     \
+        if (!(cond)) {                                                       \
+            printf("%s:%d: %s: %s\n", __FILE__, __LINE__, __func__, #cond);  \
+            failures++;                                                      \
+        }                                                                    \
+    } while (0)
+
+// One matrix scan with key 0 at `pressed`, then 1 ms passes. Returns what
+// debounce() returned.
+static bool scan(bool pressed) {
+    bool cooked_changed;
+
+    raw            = pressed;
+    cooked_changed = debounce(&raw, &cooked, MATRIX_ROWS, raw != last_raw);
+    last_raw       = raw;
+    test_now++;
+    return cooked_changed;
+}
+
+static void scan_for(bool pressed, uint8_t ms) {
+    while (ms--) {
+        scan(pressed);
+    }
+}
+
+// A press and release far enough apart that neither window nor grace overlaps.
+static void clean_tap(void) {
+    scan_for(true, 30);
+    scan_for(false, 30);
+}
+
+static void reset(void) {
+    debounce_init(MATRIX_ROWS);
+    raw = cooked = last_raw = 0;
+    counters_active         = false;
+    test_now += 1000;
+}
+
+static void adapt_window_streak_lowers_level(void) {
+    uint8_t a = PACK(3, 0);
+
+    for (uint8_t i = 1; i < ADAPTIVE_DEBOUNCE_STREAK; i++) {
+        a = adapt_window(a, false);
+        EXPECT(LEVEL(a) == 3 && STREAK(a) == i);
+    }
+    a = adapt_window(a, false);
+    EXPECT(LEVEL(a) == 2 && STREAK(a) == 0);
+}
+
+static void adapt_window_stops_at_min(void) {
+    uint8_t a = PACK(0, ADAPTIVE_DEBOUNCE_STREAK - 1);
+
+    a = adapt_window(a, false);
+    EXPECT(LEVEL(a) == 0 && STREAK(a) == 0);
+    EXPECT(window(a) == ADAPTIVE_DEBOUNCE_MIN);
+}
+
+static void adapt_window_chatter_restores_debounce(void) {
+    uint8_t a = adapt_window(PACK(0, 5) | GRACE, true);
+
+    EXPECT(a == PACK(LEVEL_MAX, 0));
+    EXPECT(window(a) == DEBOUNCE);
+}
+
+static void change_is_reported_eagerly(void) {
+    EXPECT(scan(true));
+    EXPECT(cooked == 1);
+    EXPECT(lockout[0][0] == DEBOUNCE);
+}
+
+static void bounce_inside_window_is_ignored(void) {
+    EXPECT(scan(true));
+    EXPECT(!scan(false));
+    EXPECT(!scan(true));
+    EXPECT(!scan(false));
+    EXPECT(cooked == 1);
+    scan_for(true, 30);
+    EXPECT(cooked == 1);
+    // the bounce was swallowed by the window, so it was a clean one
+    EXPECT(STREAK(adapt[0][0]) == 1);
+    EXPECT(LEVEL(adapt[0][0]) == LEVEL_MAX);
+}
+
+static void bouncy_but_clean_keys_speed_up(void) {
+    for (uint8_t i = 0; i < ADAPTIVE_DEBOUNCE_STREAK; i++) {
+        scan(true);
+        scan(false); // bounce inside the window
+        scan_for(true, 30);
+        scan_for(false, 30);
+    }
+    // two windows per tap
+    EXPECT(LEVEL(adapt[0][0]) == LEVEL_MAX - 2);
+}
+
+static void clean_taps_reach_min(void) {
+    for (uint16_t i = 0; i < ADAPTIVE_DEBOUNCE_STREAK * LEVEL_MAX; i++) {
+        clean_tap();
+    }
+    EXPECT(LEVEL(adapt[0][0]) == 0);
+    scan(true);
+    EXPECT(lockout[0][0] == ADAPTIVE_DEBOUNCE_MIN);
+}
+
+static void toggle_after_window_is_chatter(void) {
+    for (uint16_t i = 0; i < ADAPTIVE_DEBOUNCE_STREAK * LEVEL_MAX; i++) {
+        clean_tap();
+    }
+    scan(true);
+    scan_for(true, ADAPTIVE_DEBOUNCE_MIN);
+    // the contact opens again just after the short window
+    scan(false);
+    EXPECT(cooked == 0);
+    EXPECT(LEVEL(adapt[0][0]) == LEVEL_MAX);
+    EXPECT(lockout[0][0] == DEBOUNCE);
+}
+
+static void change_after_grace_is_clean(void) {
+    scan(true);
+    scan_for(true, DEBOUNCE + ADAPTIVE_DEBOUNCE_GRACE);
+    EXPECT(!(adapt[0][0] & GRACE));
+    EXPECT(lockout[0][0] == 0);
+    scan(false);
+    EXPECT(cooked == 0);
+    EXPECT(LEVEL(adapt[0][0]) == LEVEL_MAX && STREAK(adapt[0][0]) == 1);
+}
+
+static void idle_matrix_stops_timing(void) {
+    clean_tap();
+    EXPECT(!counters_active);
+}
+
+static void run(const char *name, void (*fn)(void)) {
+    int before = failures;
+
+    reset();
+    fn();
+    tests++;
+    if (failures != before) {
+        printf("FAIL %s\n", name);
+    }
+}
+
+#define RUN_TEST(fn) run(#fn, fn)
+
+int main(void) {
+    RUN_TEST(adapt_window_streak_lowers_level);
+    RUN_TEST(adapt_window_stops_at_min);
+    RUN_TEST(adapt_window_chatter_restores_debounce);
+    RUN_TEST(change_is_reported_eagerly);
+    RUN_TEST(bounce_inside_window_is_ignored);
+    RUN_TEST(bouncy_but_clean_keys_speed_up);
+    RUN_TEST(clean_taps_reach_min);
+    RUN_TEST(toggle_after_window_is_chatter);
+    RUN_TEST(change_after_grace_is_clean);
+    RUN_TEST(idle_matrix_stops_timing);
+    printf("%d tests, %d failed checks\n", tests, failures);
+    return failures ? 1 : 0;
+}
@@ -16,6 +16,7 @@
 
 #include "quantum.h"
 #include "keychron_task.h"
+#include "profiler.h"
 #ifdef FACTORY_TEST_ENABLE
 #    include "factory_test.h"
 #    include "keychron_common.h"
@@ -53,14 +54,14 @@ void keyboard_post_init_kb(void) {
 #endif
 
     power_on_indicator_timer_buffer = timer_read32();
-#ifdef ENCODER_ENABLE
-    encoder_cb_init();
-#endif
+    profiler_init();
 
     keyboard_post_init_user();
 }
 
 bool keychron_task_kb(void) {
+    uint32_t start = profiler_begin();
+
     if (power_on_indicator_timer_buffer) {
         if (timer_elapsed32(power_on_indicator_timer_buffer) > POWER_ON_LED_DURATION) {
             power_on_indicator_timer_buffer = 0;
@@ -75,6 +76,7 @@ bool keychron_task_kb(void) {
 #endif
         }
     }
+    profiler_end(PROF_KEYCHRON_TASK, start);
     return true;
 }
 
@@ -1,2 +1,5 @@
+USER_NAME := muge
+
 TAP_DANCE_ENABLE = yes
-COMBO_ENABLE = yes
+MUGE_POS_COMBO_ENABLE = yes
+#MUGE_SCAN_STATS_ENABLE = yes # idle-scan ratio, printed with CONSOLE_ENABLE = yes
@@ -0,0 +1,35 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "active_slot.h"
+
+static active_slot_t active_slots[MUGE_ACTIVE_SLOTS];
+
+active_slot_t *active_slot_acquire(uint16_t owner) {
+    for (uint8_t i = 0; i < MUGE_ACTIVE_SLOTS; i++) {
+        active_slot_t *slot = &active_slots[i];
+
+        if (!slot->owner) {
+            *slot = (active_slot_t){
+                .owner = owner,
+                .timer = timer_read(),
+                .token = INVALID_DEFERRED_TOKEN,
+            };
+            return slot;
+        }
+    }
+    return NULL;
+}
+
+active_slot_t *active_slot_find(uint16_t owner) {
+    for (uint8_t i = 0; i < MUGE_ACTIVE_SLOTS; i++) {
+        if (active_slots[i].owner == owner) {
+            return &active_slots[i];
+        }
+    }
+    return NULL;
+}
+
+void active_slot_release(active_slot_t *slot) {
+    slot->owner = 0;
+}
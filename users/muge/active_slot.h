@@ -0,0 +1,41 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+#include "journal.h"
+
+/* Pool of active-key slots.
+ *
+ * Dual-role keys only need timing and release state while they are down,
+ * and only a few are ever down at once. Every such behaviour takes a slot
+ * from one shared pool on press and gives it back on release, so RAM scales
+ * with MUGE_ACTIVE_SLOTS rather than with the number of keys defined.
+ *
+ * A slot is owned by ACTIVE_TAP_HOLD or ACTIVE_TAP_DANCE combined with the
+ * row index of the key, which is how it is found again on release.
+ */
+
+#ifndef MUGE_ACTIVE_SLOTS
+#    define MUGE_ACTIVE_SLOTS 4
+#endif
+
+#define ACTIVE_TAP_HOLD 0x0100
+#define ACTIVE_TAP_DANCE 0x0200
+
+#define ACTIVE_SLOT_INDEX(owner) ((uint8_t)(owner))
+
+typedef struct {
+    uint16_t       owner;    // ACTIVE_* | row index, 0 when free
+    uint16_t       timer;    // timer_read() at acquire
+    uint16_t       interval; // next auto-repeat interval
+    deferred_token token;    // pending callback, INVALID_DEFERRED_TOKEN if none
+    bool           held;     // hold action already sent for this press
+    journal_t      journal;  // actions to release with the key
+} active_slot_t;
+
+// NULL when every slot is in use
+active_slot_t *active_slot_acquire(uint16_t owner);
+active_slot_t *active_slot_find(uint16_t owner);
+void           active_slot_release(active_slot_t *slot);
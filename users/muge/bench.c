@@ -0,0 +1,30 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "bench.h"
+#include "timing.h"
+#include "print.h"
+
+static uint32_t bench_min = UINT32_MAX;
+static uint32_t bench_max;
+static uint32_t bench_sum;
+static uint16_t bench_count;
+
+void bench_init(void) {
+    timing_init();
+}
+
+void bench_record(uint32_t ticks) {
+    bench_min = MIN(bench_min, ticks);
+    bench_max = MAX(bench_max, ticks);
+    bench_sum += ticks;
+    if (++bench_count < BENCH_REPORT_EVENTS) {
+        return;
+    }
+
+    uprintf("process_record_user: %u events, ns min %lu avg %lu max %lu\n", bench_count, timing_ticks_to_ns(bench_min), timing_ticks_to_ns(bench_sum / bench_count), timing_ticks_to_ns(bench_max));
+    bench_min   = UINT32_MAX;
+    bench_max   = 0;
+    bench_sum   = 0;
+    bench_count = 0;
+}
@@ -0,0 +1,20 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Per-event cost of process_record_user().
+ *
+ * With MUGE_BENCH_ENABLE the userspace times every call into the keymap's
+ * process_record_keymap() and prints min/avg/max over each window of
+ * BENCH_REPORT_EVENTS events to the console (`qmk console`).
+ */
+
+#ifndef BENCH_REPORT_EVENTS
+#    define BENCH_REPORT_EVENTS 64
+#endif
+
+void bench_init(void);
+void bench_record(uint32_t ticks);
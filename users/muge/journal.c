@@ -0,0 +1,60 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "journal.h"
+
+enum {
+    JOURNAL_KEY,
+    JOURNAL_LAYER,
+    JOURNAL_MODS,
+};
+
+static bool journal_push(journal_t *journal, uint8_t kind, uint8_t arg, uint16_t keycode) {
+    if (journal->len == JOURNAL_SIZE) {
+        return false;
+    }
+    journal->entries[journal->len++] = (journal_entry_t){.kind = kind, .arg = arg, .keycode = keycode};
+    return true;
+}
+
+bool journal_register_code16(journal_t *journal, uint16_t keycode) {
+    if (!journal_push(journal, JOURNAL_KEY, 0, keycode)) {
+        return false;
+    }
+    register_code16(keycode);
+    return true;
+}
+
+bool journal_layer_on(journal_t *journal, uint8_t layer) {
+    if (!journal_push(journal, JOURNAL_LAYER, layer, KC_NO)) {
+        return false;
+    }
+    layer_on(layer);
+    return true;
+}
+
+bool journal_register_mods(journal_t *journal, uint8_t mods) {
+    if (!journal_push(journal, JOURNAL_MODS, mods, KC_NO)) {
+        return false;
+    }
+    register_mods(mods);
+    return true;
+}
+
+void journal_undo(journal_t *journal) {
+    while (journal->len) {
+        const journal_entry_t *entry = &journal->entries[--journal->len];
+
+        switch (entry->kind) {
+            case JOURNAL_KEY:
+                unregister_code16(entry->keycode);
+                break;
+            case JOURNAL_LAYER:
+                layer_off(entry->arg);
+                break;
+            case JOURNAL_MODS:
+                unregister_mods(entry->arg);
+                break;
+        }
+    }
+}
@@ -0,0 +1,37 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Paired-release journal.
+ *
+ * Dual-role keys press their hold action through a journal_t instead of
+ * calling register_code16(), layer_on() or register_mods() directly. The
+ * journal remembers what was pressed and journal_undo() releases exactly
+ * that, newest first, so a release can never miss or mismatch its press.
+ *
+ * An action that does not fit into a full journal is not performed at all;
+ * dropping a press is better than a key or layer stuck until replug.
+ */
+
+#ifndef JOURNAL_SIZE
+#    define JOURNAL_SIZE 3
+#endif
+
+typedef struct {
+    uint8_t  kind;    // JOURNAL_*
+    uint8_t  arg;     // layer or 8-bit mods
+    uint16_t keycode; // registered keycode
+} journal_entry_t;
+
+typedef struct {
+    uint8_t         len;
+    journal_entry_t entries[JOURNAL_SIZE];
+} journal_t;
+
+bool journal_register_code16(journal_t *journal, uint16_t keycode);
+bool journal_layer_on(journal_t *journal, uint8_t layer);
+bool journal_register_mods(journal_t *journal, uint8_t mods);
+void journal_undo(journal_t *journal);
@@ -0,0 +1,202 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "key_trace.h"
+#include "timing.h"
+#include "raw_hid.h"
+#ifdef MUGE_SCAN_STATS_ENABLE
+#    include "scan_stats.h"
+#endif
+
+_Static_assert((KEY_TRACE_BUFFER_SIZE & (KEY_TRACE_BUFFER_SIZE - 1)) == 0, "KEY_TRACE_BUFFER_SIZE must be a power of two");
+
+#define KEY_TRACE_RECORD_MAX 8 // two varints of up to 32 bits
+#define KEY_TRACE_HEADER 3
+
+static uint8_t  trace_buffer[KEY_TRACE_BUFFER_SIZE];
+static uint16_t trace_head;
+static uint16_t trace_tail;
+static uint16_t trace_dropped;
+static uint8_t  trace_seq;
+static uint16_t trace_sent; // timer_read() of the last KEY_TRACE_DATA report
+static bool     trace_recording;
+static bool     trace_streaming;
+static bool     trace_replaying;
+static uint32_t trace_replay_due; // trace_us of the next replayed event
+
+// microsecond clock, kept up to date from the main loop so the tick counter
+// never wraps between two reads
+static uint32_t trace_ticks;
+static uint32_t trace_us;
+static uint32_t trace_last_us;
+
+static uint32_t trace_clock(void) {
+    uint32_t us = (timing_now() - trace_ticks) / TIMING_TICKS_PER_US;
+
+    trace_ticks += us * TIMING_TICKS_PER_US;
+    trace_us += us;
+    return trace_us;
+}
+
+static uint16_t trace_used(void) {
+    return (trace_head - trace_tail) & (KEY_TRACE_BUFFER_SIZE - 1);
+}
+
+static void trace_put_varint(uint32_t value) {
+    while (value >= 0x80) {
+        trace_buffer[trace_head] = value | 0x80;
+        trace_head               = (trace_head + 1) & (KEY_TRACE_BUFFER_SIZE - 1);
+        value >>= 7;
+    }
+    trace_buffer[trace_head] = value;
+    trace_head               = (trace_head + 1) & (KEY_TRACE_BUFFER_SIZE - 1);
+}
+
+// Decodes one varint at `*pos` without consuming it; false if incomplete or
+// longer than 32 bits.
+static bool trace_peek_varint(uint16_t *pos, uint32_t *value) {
+    uint16_t end = trace_head;
+
+    *value = 0;
+    for (uint8_t shift = 0; shift < 32; shift += 7) {
+        if (*pos == end) {
+            return false;
+        }
+        uint8_t byte = trace_buffer[*pos];
+        *pos         = (*pos + 1) & (KEY_TRACE_BUFFER_SIZE - 1);
+        *value |= (uint32_t)(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void trace_replay_stop(void) {
+    uint8_t report[RAW_EPSIZE] = {KEY_TRACE_CMD_REPLAY, 0};
+
+    trace_replaying = false;
+    raw_hid_send(report, RAW_EPSIZE);
+}
+
+static void trace_replay_task(uint32_t now) {
+    while (trace_replaying) {
+        uint16_t pos = trace_tail;
+        uint32_t delta, code;
+
+        // a host-supplied trace is untrusted: stop at the first bad record
+        if (!trace_peek_varint(&pos, &delta) || !trace_peek_varint(&pos, &code) || code >> 1 >= MATRIX_ROWS * MATRIX_COLS) {
+            trace_replay_stop();
+            return;
+        }
+        if ((int32_t)(now - (trace_replay_due + delta)) < 0) {
+            return;
+        }
+
+        uint16_t index = code >> 1;
+        trace_tail    = pos;
+        trace_replay_due += delta;
+        action_exec(MAKE_KEYEVENT(index / MATRIX_COLS, index % MATRIX_COLS, code & 1));
+    }
+}
+
+void key_trace_record(keyrecord_t *record) {
+    if (!trace_recording || trace_replaying || !IS_KEYEVENT(record->event)) {
+        return;
+    }
+
+    uint32_t now = trace_clock();
+    if (KEY_TRACE_BUFFER_SIZE - 1 - trace_used() < KEY_TRACE_RECORD_MAX) {
+        trace_dropped++;
+        return;
+    }
+
+    keypos_t key = record->event.key;
+    trace_put_varint(now - trace_last_us);
+    trace_put_varint((key.row * MATRIX_COLS + key.col) << 1 | record->event.pressed);
+    trace_last_us = now;
+}
+
+void key_trace_task(void) {
+    uint32_t now = trace_clock();
+
+    if (trace_replaying) {
+        trace_replay_task(now);
+        return;
+    }
+    if (!trace_streaming || !trace_used() || timer_elapsed(trace_sent) < KEY_TRACE_SEND_INTERVAL) {
+        return;
+    }
+
+    uint8_t report[RAW_EPSIZE] = {KEY_TRACE_DATA, trace_seq++};
+    uint8_t length             = MIN(trace_used(), RAW_EPSIZE - KEY_TRACE_HEADER);
+
+    report[2] = length;
+    for (uint8_t i = 0; i < length; i++) {
+        report[KEY_TRACE_HEADER + i] = trace_buffer[trace_tail];
+        trace_tail                   = (trace_tail + 1) & (KEY_TRACE_BUFFER_SIZE - 1);
+    }
+    raw_hid_send(report, RAW_EPSIZE);
+    trace_sent = timer_read();
+}
+
+bool key_trace_raw_hid(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+        case KEY_TRACE_CMD_START:
+            trace_head = trace_tail = 0;
+            trace_dropped           = 0;
+            trace_seq               = 0;
+            trace_last_us           = trace_clock();
+            trace_recording         = true;
+            break;
+        case KEY_TRACE_CMD_STOP:
+            trace_recording = false;
+            break;
+        case KEY_TRACE_CMD_STREAM:
+            trace_streaming = data[1];
+            break;
+        case KEY_TRACE_CMD_STATUS: {
+            uint16_t used = trace_used();
+            data[1]       = trace_recording;
+            data[2]       = trace_streaming;
+            data[3]       = used & 0xFF;
+            data[4]       = used >> 8;
+            data[5]       = trace_dropped & 0xFF;
+            data[6]       = trace_dropped >> 8;
+            data[7]       = trace_replaying;
+#ifdef MUGE_SCAN_STATS_ENABLE
+            data[8] = scan_stats_idle_permille() & 0xFF;
+            data[9] = scan_stats_idle_permille() >> 8;
+#else
+            data[8] = 0;
+            data[9] = 0;
+#endif
+            break;
+        }
+        case KEY_TRACE_CMD_LOAD: {
+            uint8_t count = MIN(data[1], length - 2);
+            if (trace_recording || trace_replaying || KEY_TRACE_BUFFER_SIZE - 1 - trace_used() < count) {
+                data[1] = 0;
+                break;
+            }
+            for (uint8_t i = 0; i < count; i++) {
+                trace_buffer[trace_head] = data[2 + i];
+                trace_head               = (trace_head + 1) & (KEY_TRACE_BUFFER_SIZE - 1);
+            }
+            break;
+        }
+        case KEY_TRACE_CMD_REPLAY:
+            if (trace_replaying && !data[1]) {
+                // aborted mid-trace, do not leave replayed keys held
+                clear_keyboard();
+            }
+            trace_replaying  = data[1] && !trace_recording;
+            trace_replay_due = trace_clock();
+            data[1]          = trace_replaying;
+            break;
+        default:
+            return false;
+    }
+    raw_hid_send(data, length);
+    return true;
+}
@@ -0,0 +1,69 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Key-event trace recorder.
+ *
+ * Matrix events are appended to a RAM ring buffer as two varints each:
+ *
+ *   delta_us                       time since the previous recorded event
+ *   (row * MATRIX_COLS + col) << 1 | pressed
+ *
+ * The first event after KEY_TRACE_CMD_START is relative to the start command.
+ * Events that do not fit are dropped and counted rather than overwriting
+ * older ones, so a decoded trace never has a hole in the middle.
+ *
+ * Host protocol over raw HID, byte 0 is the command:
+ *
+ *   KEY_TRACE_CMD_START   clear the buffer and start recording
+ *   KEY_TRACE_CMD_STOP    stop recording
+ *   KEY_TRACE_CMD_STREAM  byte 1 = 1 to stream, 0 to stop streaming
+ *   KEY_TRACE_CMD_STATUS  reply: recording, streaming, used (u16), dropped (u16),
+ *                         replaying, idle-scan permille (u16, 0 without
+ *                         MUGE_SCAN_STATS_ENABLE)
+ *   KEY_TRACE_CMD_LOAD    byte 1 = length, then that many trace bytes to append
+ *   KEY_TRACE_CMD_REPLAY  byte 1 = 1 to start replaying the loaded trace, 0 to
+ *                         abort
+ *
+ * Every command is acknowledged by echoing the report back. While streaming,
+ * a KEY_TRACE_DATA report is sent whenever data is pending, at most one per
+ * KEY_TRACE_SEND_INTERVAL ms so a full IN endpoint never stalls the scan
+ * loop: KEY_TRACE_DATA, sequence, length, payload. The payload is a slice
+ * of the byte stream; records may span reports.
+ *
+ * Replay feeds a trace in the same format back through action_exec() at its
+ * recorded offsets, so the real keymap, tap-hold and tap-dance code decide
+ * on it and the host captures the resulting HID reports. Recording is paused
+ * while replaying; a KEY_TRACE_CMD_REPLAY report with byte 1 = 0 is sent when
+ * the trace runs out or reaches a record with a bad varint or a position
+ * outside the matrix. Combined with MUGE_BENCH_ENABLE this gives latency,
+ * misfires and per-event cost for a term or engine change on real data.
+ */
+
+#ifndef KEY_TRACE_BUFFER_SIZE
+#    define KEY_TRACE_BUFFER_SIZE 2048
+#endif
+
+// the raw HID IN endpoint is polled once per USB_POLLING_INTERVAL_MS
+#ifndef KEY_TRACE_SEND_INTERVAL
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define KEY_TRACE_SEND_INTERVAL USB_POLLING_INTERVAL_MS
+#    else
+#        define KEY_TRACE_SEND_INTERVAL 1
+#    endif
+#endif
+
+#define KEY_TRACE_CMD_START 0xE0
+#define KEY_TRACE_CMD_STOP 0xE1
+#define KEY_TRACE_CMD_STREAM 0xE2
+#define KEY_TRACE_CMD_STATUS 0xE3
+#define KEY_TRACE_DATA 0xE4
+#define KEY_TRACE_CMD_LOAD 0xE5
+#define KEY_TRACE_CMD_REPLAY 0xE6
+
+void key_trace_record(keyrecord_t *record);
+void key_trace_task(void);
+bool key_trace_raw_hid(uint8_t *data, uint8_t length);
@@ -0,0 +1,176 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "knob.h"
+
+static uint16_t knob_last[NUM_ENCODERS];
+static uint8_t  knob_dir[NUM_ENCODERS]; // event type of the last detent
+static uint8_t  knob_step = 1;
+
+#ifdef POINTING_DEVICE_ENABLE
+#    ifdef WHEEL_EXTENDED_REPORT
+#        define KNOB_WHEEL_MAX INT16_MAX
+#    else
+#        define KNOB_WHEEL_MAX INT8_MAX
+#    endif
+
+// wheel units still to be sent, drained by the pointing device task
+static int32_t knob_wheel_v;
+static int32_t knob_wheel_h;
+
+// wheel units per step, a fraction of a notch with hi-res scrolling
+static int16_t knob_wheel_units(void) {
+#    ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+    return MAX(1, pointing_device_get_hires_scroll_resolution() / KNOB_HIRES_DIVISOR);
+#    else
+    return 1;
+#    endif
+}
+
+static void knob_add_wheel(uint16_t keycode, int16_t units) {
+    switch (keycode) {
+        case MS_WHLU: knob_wheel_v += units; break;
+        case MS_WHLD: knob_wheel_v -= units; break;
+        case MS_WHLR: knob_wheel_h += units; break;
+        case MS_WHLL: knob_wheel_h -= units; break;
+    }
+}
+
+// mods held across a burst of knob_mod_wheel() detents, and whether the
+// report carrying the last of their wheel units has gone out
+static uint8_t knob_latched_mods;
+static bool    knob_latch_sent;
+
+void knob_mod_wheel(uint16_t keycode, uint8_t mods) {
+    if (mods & ~knob_latched_mods) {
+        register_mods(mods & ~knob_latched_mods);
+        knob_latched_mods |= mods;
+    }
+    // one notch per step, even with hi-res scrolling
+    knob_add_wheel(keycode, knob_step * knob_wheel_units() * KNOB_HIRES_DIVISOR);
+    knob_latch_sent = false;
+}
+#endif
+
+#ifdef EXTRAKEY_ENABLE
+_Static_assert((KNOB_CONSUMER_QUEUE & (KNOB_CONSUMER_QUEUE - 1)) == 0, "KNOB_CONSUMER_QUEUE must be a power of two");
+
+// consumer keycodes still to be tapped, one per housekeeping pass
+static uint16_t knob_queue[KNOB_CONSUMER_QUEUE];
+static uint8_t  knob_head;
+static uint8_t  knob_tail;
+#endif
+
+static uint8_t knob_accelerate(uint8_t index, keyrecord_t *record) {
+    uint8_t  layer    = get_highest_layer(layer_state | default_layer_state);
+    uint16_t interval = timer_elapsed(knob_last[index]);
+    bool     same_dir = knob_dir[index] == record->event.type;
+
+    knob_last[index] = timer_read();
+    knob_dir[index]  = record->event.type;
+    if (layer >= knob_curve_layers || !same_dir) {
+        return 1;
+    }
+
+    knob_curve_t curve;
+
+    memcpy_P(&curve, &knob_curves[layer][index], sizeof(curve));
+    if (interval >= curve.threshold || curve.max_step <= 1) {
+        return 1;
+    }
+    return 1 + (uint16_t)(curve.threshold - interval) * (curve.max_step - 1) / curve.threshold;
+}
+
+// Takes over wheel and consumer detents, returns false if the keycode was queued.
+static bool knob_coalesce(uint16_t keycode, bool pressed) {
+#ifdef EXTRAKEY_ENABLE
+    if (IS_CONSUMER_KEYCODE(keycode)) {
+        for (uint8_t i = 0; pressed && i < knob_step; i++) {
+            uint8_t next = (knob_head + 1) & (KNOB_CONSUMER_QUEUE - 1);
+
+            // a full queue drops the extra steps rather than blocking the scan
+            if (next == knob_tail) {
+                break;
+            }
+            knob_queue[knob_head] = keycode;
+            knob_head             = next;
+        }
+        return false;
+    }
+#endif
+#ifdef POINTING_DEVICE_ENABLE
+    switch (keycode) {
+        case MS_WHLU:
+        case MS_WHLD:
+        case MS_WHLL:
+        case MS_WHLR:
+            if (pressed) {
+                knob_add_wheel(keycode, knob_step * knob_wheel_units());
+            }
+            return false;
+    }
+#endif
+    return true;
+}
+
+bool knob_process_record(uint16_t keycode, keyrecord_t *record) {
+    uint8_t index = record->event.key.col;
+
+    if (!IS_ENCODEREVENT(record->event) || index >= NUM_ENCODERS) {
+        return true;
+    }
+
+    if (record->event.pressed) {
+        knob_step = knob_accelerate(index, record);
+    }
+    if (!knob_coalesce(keycode, record->event.pressed)) {
+        return false;
+    }
+
+    // the detent itself is still processed normally, only the extra steps are sent here
+    if (record->event.pressed && keycode <= QK_MODS_MAX) {
+        for (uint8_t i = 1; i < knob_step; i++) {
+            tap_code16(keycode);
+        }
+    }
+    return true;
+}
+
+uint8_t knob_steps(void) {
+    return knob_step;
+}
+
+void knob_task(void) {
+#ifdef POINTING_DEVICE_ENABLE
+    // housekeeping runs after the pointing device task has sent its report
+    if (knob_latch_sent) {
+        unregister_mods(knob_latched_mods);
+        knob_latched_mods = 0;
+        knob_latch_sent   = false;
+    }
+#endif
+#ifdef EXTRAKEY_ENABLE
+    // tapped through the action layer, which keeps the extrakey report state
+    if (knob_tail != knob_head) {
+        tap_code16(knob_queue[knob_tail]);
+        knob_tail = (knob_tail + 1) & (KNOB_CONSUMER_QUEUE - 1);
+    }
+#endif
+}
+
+#ifdef POINTING_DEVICE_ENABLE
+report_mouse_t knob_pointing_device_task(report_mouse_t mouse) {
+    mouse_hv_report_t v = MAX(-KNOB_WHEEL_MAX, MIN(KNOB_WHEEL_MAX, knob_wheel_v));
+    mouse_hv_report_t h = MAX(-KNOB_WHEEL_MAX, MIN(KNOB_WHEEL_MAX, knob_wheel_h));
+
+    // whatever does not fit into this report goes out with the next one
+    mouse.v += v;
+    mouse.h += h;
+    knob_wheel_v -= v;
+    knob_wheel_h -= h;
+    if (knob_latched_mods && !knob_wheel_v && !knob_wheel_h) {
+        knob_latch_sent = true;
+    }
+    return mouse;
+}
+#endif
@@ -0,0 +1,64 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Encoder velocity acceleration.
+ *
+ * Each encoder-map detent is timed against the previous detent of the same
+ * encoder turning the same way. A detent that arrives sooner than the
+ * curve's threshold counts as more than one step, ramping linearly up to
+ * max_step as the interval approaches zero. For basic keycodes (with or
+ * without mods) the extra steps are tapped right away. Custom keycodes can
+ * read the step count with knob_steps() and scale their own action.
+ *
+ * Curves come from the keymap, one per encoder and per layer. Layers past
+ * the end of the table and KNOB_NONE entries do not accelerate.
+ *
+ * Wheel and consumer detents are not sent one press/release pair at a time.
+ * With POINTING_DEVICE_ENABLE, wheel steps are summed and leave with the next
+ * pointing device report. With EXTRAKEY_ENABLE, consumer steps go into a
+ * bounded queue that knob_task() drains with one tap_code16() per
+ * housekeeping pass, so nothing waits in the scan loop.
+ *
+ * With POINTING_DEVICE_HIRES_SCROLL_ENABLE the wheel report advertises the
+ * HID resolution multiplier, and each step sends 1/KNOB_HIRES_DIVISOR of a
+ * notch in hi-res units.
+ *
+ * knob_mod_wheel() is for custom keycodes such as Alt+wheel zoom. It
+ * presses the mods and adds whole notches to the pending wheel delta. The
+ * mods are released by the next knob_task() after the report carrying the
+ * last pending notch, so detents that coalesce into one report share one
+ * mod press and release.
+ */
+
+#ifndef KNOB_HIRES_DIVISOR
+#    define KNOB_HIRES_DIVISOR 1 // fraction of a notch per step with hi-res scrolling
+#endif
+
+#ifndef KNOB_CONSUMER_QUEUE
+#    define KNOB_CONSUMER_QUEUE 16 // power of two, one slot stays free
+#endif
+
+typedef struct {
+    uint8_t threshold; // ms between detents below which steps multiply, 0 for none
+    uint8_t max_step;  // steps sent for a detent arriving right after the last
+} knob_curve_t;
+
+#define KNOB_CURVE(threshold, max_step) {threshold, max_step}
+#define KNOB_NONE {0, 1}
+
+// provided by the keymap
+extern const knob_curve_t knob_curves[][NUM_ENCODERS];
+extern const uint8_t      knob_curve_layers;
+
+// Called from process_record_user() for every event; false if it was queued.
+bool    knob_process_record(uint16_t keycode, keyrecord_t *record);
+uint8_t knob_steps(void);
+void    knob_task(void);
+#ifdef POINTING_DEVICE_ENABLE
+void           knob_mod_wheel(uint16_t keycode, uint8_t mods);
+report_mouse_t knob_pointing_device_task(report_mouse_t mouse);
+#endif
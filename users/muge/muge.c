@@ -0,0 +1,139 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "muge.h"
+#ifdef MUGE_BENCH_ENABLE
+#    include "bench.h"
+#endif
+#ifdef MUGE_SCAN_STATS_ENABLE
+#    include "scan_stats.h"
+#endif
+#ifdef MUGE_KEY_TRACE_ENABLE
+#    include "key_trace.h"
+#endif
+#if defined(MUGE_BENCH_ENABLE) || defined(MUGE_KEY_TRACE_ENABLE)
+#    include "timing.h"
+#endif
+
+__attribute__((weak)) void keyboard_post_init_keymap(void) {}
+
+__attribute__((weak)) void housekeeping_task_keymap(void) {}
+
+__attribute__((weak)) bool pre_process_record_keymap(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+__attribute__((weak)) bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
+
+void keyboard_post_init_user(void) {
+#ifdef MUGE_TAP_HOLD_ENABLE
+    tap_hold_init();
+#endif
+#ifdef MUGE_POS_COMBO_ENABLE
+    pos_combo_init();
+#endif
+#ifdef MUGE_BENCH_ENABLE
+    bench_init();
+#endif
+#ifdef MUGE_KEY_TRACE_ENABLE
+    timing_init();
+#endif
+    keyboard_post_init_keymap();
+}
+
+void housekeeping_task_user(void) {
+#ifdef MUGE_KNOB_ENABLE
+    knob_task();
+#endif
+#ifdef MUGE_SCAN_STATS_ENABLE
+    scan_stats_task();
+#endif
+#ifdef MUGE_KEY_TRACE_ENABLE
+    key_trace_task();
+#endif
+    housekeeping_task_keymap();
+}
+
+#ifdef MUGE_KEY_TRACE_ENABLE
+// Combos and permissive tap dances hold events back and replay them later.
+static bool is_replaying(void) {
+#ifdef MUGE_POS_COMBO_ENABLE
+    if (pos_combo_is_replaying()) return true;
+#endif
+#ifdef TAP_DANCE_ENABLE
+    if (td_is_replaying()) return true;
+#endif
+    return false;
+}
+#endif
+
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record) {
+#ifdef MUGE_KEY_TRACE_ENABLE
+    // replayed events were traced when they were held back
+    if (!is_replaying()) {
+        key_trace_record(record);
+    }
+#endif
+#ifdef MUGE_POS_COMBO_ENABLE
+    if (!pos_combo_pre_process_record(record)) {
+        return false;
+    }
+#endif
+#ifdef TAP_DANCE_ENABLE
+    if (!td_pre_process_record(keycode, record)) {
+        return false;
+    }
+#endif
+    return pre_process_record_keymap(keycode, record);
+}
+
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+#ifdef MUGE_KNOB_ENABLE
+    if (!knob_process_record(keycode, record)) {
+        return false;
+    }
+#endif
+#ifdef MUGE_BENCH_ENABLE
+    uint32_t start = timing_now();
+    bool     ret   = process_record_keymap(keycode, record);
+    bench_record(timing_now() - start);
+    return ret;
+#else
+    return process_record_keymap(keycode, record);
+#endif
+}
+
+#ifdef MUGE_KEY_TRACE_ENABLE
+// Trace commands are taken off raw_hid_receive() with -Wl,--wrap (see
+// rules.mk), ahead of whichever of VIA or the keyboard code owns it. A
+// keyboard that wraps raw_hid_receive() itself defines RAW_HID_INTERCEPT_KB
+// and calls this from its own wrapper.
+bool raw_hid_intercept_user(uint8_t *data, uint8_t length) {
+    return key_trace_raw_hid(data, length);
+}
+
+#    ifndef RAW_HID_INTERCEPT_KB
+void __real_raw_hid_receive(uint8_t *data, uint8_t length);
+
+void __wrap_raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (!raw_hid_intercept_user(data, length)) {
+        __real_raw_hid_receive(data, length);
+    }
+}
+#    endif
+#endif
+
+#ifdef POINTING_DEVICE_ENABLE
+__attribute__((weak)) report_mouse_t pointing_device_task_keymap(report_mouse_t mouse) {
+    return mouse;
+}
+
+report_mouse_t pointing_device_task_user(report_mouse_t mouse) {
+#    ifdef MUGE_KNOB_ENABLE
+    mouse = knob_pointing_device_task(mouse);
+#    endif
+    return pointing_device_task_keymap(mouse);
+}
+#endif
@@ -0,0 +1,31 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+#ifdef MUGE_TAP_HOLD_ENABLE
+#    include "tap_hold.h"
+#endif
+#ifdef TAP_DANCE_ENABLE
+#    include "tap_dance.h"
+#endif
+#ifdef MUGE_POS_COMBO_ENABLE
+#    include "pos_combo.h"
+#endif
+#ifdef MUGE_KNOB_ENABLE
+#    include "knob.h"
+#endif
+
+/* Hooks the userspace owns are forwarded to these keymap-level variants. */
+void keyboard_post_init_keymap(void);
+void housekeeping_task_keymap(void);
+bool pre_process_record_keymap(uint16_t keycode, keyrecord_t *record);
+bool process_record_keymap(uint16_t keycode, keyrecord_t *record);
+#ifdef POINTING_DEVICE_ENABLE
+report_mouse_t pointing_device_task_keymap(report_mouse_t mouse);
+#endif
+
+// true when the report was consumed, see muge.c
+bool raw_hid_intercept_user(uint8_t *data, uint8_t length);
@@ -0,0 +1,230 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "pos_combo.h"
+
+#if MATRIX_ROWS * MATRIX_COLS <= 32
+typedef uint32_t pos_mask_t;
+#elif MATRIX_ROWS * MATRIX_COLS <= 64
+typedef uint64_t pos_mask_t;
+#else
+#    error "pos_combo supports matrices of up to 64 keys"
+#endif
+
+_Static_assert(POS_COMBO_MAX <= 8, "combo sets are kept in a byte");
+
+#define POS_BIT(key) ((pos_mask_t)1 << ((key).row * MATRIX_COLS + (key).col))
+
+// per layer: the positions of every combo, 0 if it cannot be typed there
+static pos_mask_t combo_masks[POS_COMBO_LAYERS][POS_COMBO_MAX];
+// per layer: union of the above, the fast reject for keys in no combo
+static pos_mask_t combo_keys[POS_COMBO_LAYERS];
+
+// combo being typed
+static uint8_t        candidates; // combos still possible, bit per combo
+static uint8_t        layer;
+static pos_mask_t     pressed;
+static keyevent_t     buffer[POS_COMBO_MAX_KEYS];
+static uint8_t        buffered;
+static deferred_token timeout = INVALID_DEFERRED_TOKEN;
+static bool           replaying;
+
+// per combo: keys still down since it fired, and the action to release
+static pos_mask_t held[POS_COMBO_MAX];
+static uint16_t   held_action[POS_COMBO_MAX];
+
+static uint16_t resolve_keycode(uint8_t top, keypos_t key) {
+    for (int8_t l = top; l >= 0; l--) {
+        uint16_t keycode = keymap_key_to_keycode(l, key);
+
+        if (keycode != KC_TRNS) {
+            return keycode;
+        }
+    }
+    return KC_NO;
+}
+
+// Matches each combo key to the first matrix position that types it.
+static pos_mask_t combo_mask(uint8_t l, uint8_t index) {
+    pos_mask_t mask = 0;
+
+    for (uint8_t k = 0; k < POS_COMBO_MAX_KEYS; k++) {
+        uint16_t keycode = pgm_read_word(&pos_combos[index].keys[k]);
+        bool     found   = false;
+
+        if (keycode == KC_NO) {
+            break;
+        }
+        for (uint8_t row = 0; row < MATRIX_ROWS && !found; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS && !found; col++) {
+                keypos_t key = {.row = row, .col = col};
+
+                if (!(mask & POS_BIT(key)) && resolve_keycode(l, key) == keycode) {
+                    mask |= POS_BIT(key);
+                    found = true;
+                }
+            }
+        }
+        if (!found) {
+            return 0;
+        }
+    }
+    return mask;
+}
+
+void pos_combo_init(void) {
+    uint8_t layers = MIN(keymap_layer_count(), POS_COMBO_LAYERS);
+
+    for (uint8_t l = 0; l < layers; l++) {
+        for (uint8_t i = 0; i < pos_combo_count && i < POS_COMBO_MAX; i++) {
+            combo_masks[l][i] = combo_mask(l, i);
+            combo_keys[l] |= combo_masks[l][i];
+        }
+    }
+}
+
+bool pos_combo_is_replaying(void) {
+    return replaying;
+}
+
+static void cancel_timeout(void) {
+    if (timeout != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(timeout);
+        timeout = INVALID_DEFERRED_TOKEN;
+    }
+}
+
+static void reset_typing(void) {
+    cancel_timeout();
+    candidates = 0;
+    pressed    = 0;
+    buffered   = 0;
+}
+
+// Hands the held-back presses to the normal pipeline in their original order.
+static void flush(void) {
+    uint8_t count = buffered;
+
+    reset_typing();
+    replaying = true;
+    for (uint8_t i = 0; i < count; i++) {
+        action_exec(buffer[i]);
+    }
+    replaying = false;
+}
+
+static void fire(uint8_t index) {
+    uint16_t action = pgm_read_word(&pos_combos[index].action);
+
+    held[index] = pressed;
+    reset_typing();
+    if (IS_QK_TOGGLE_LAYER(action)) {
+        layer_invert(QK_TOGGLE_LAYER_GET_LAYER(action));
+        held_action[index] = KC_NO;
+    } else {
+        register_code16(action);
+        held_action[index] = action;
+    }
+}
+
+// Index of the candidate whose keys are exactly the pressed ones, or -1.
+static int8_t complete_candidate(void) {
+    for (uint8_t i = 0; i < POS_COMBO_MAX; i++) {
+        if ((candidates & (1 << i)) && combo_masks[layer][i] == pressed) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static uint32_t timeout_callback(uint32_t trigger_time, void *cb_arg) {
+    int8_t index = complete_candidate();
+
+    timeout = INVALID_DEFERRED_TOKEN;
+    if (index >= 0) {
+        fire(index);
+    } else {
+        flush();
+    }
+    return 0;
+}
+
+static uint8_t candidates_for(pos_mask_t keys) {
+    uint8_t set = 0;
+
+    for (uint8_t i = 0; i < POS_COMBO_MAX; i++) {
+        pos_mask_t mask = combo_masks[layer][i];
+
+        if (mask && (mask & keys) == keys) {
+            set |= 1 << i;
+        }
+    }
+    return set;
+}
+
+static bool press(keyrecord_t *record) {
+    pos_mask_t bit = POS_BIT(record->event.key);
+
+    if (!buffered) {
+        layer = get_highest_layer(layer_state | default_layer_state);
+        if (layer >= POS_COMBO_LAYERS || !(combo_keys[layer] & bit)) {
+            return true;
+        }
+    }
+
+    uint8_t next = candidates_for(pressed | bit);
+
+    if (!next || buffered == POS_COMBO_MAX_KEYS) {
+        // the typed keys are not a combo, and this key may start one
+        flush();
+        return press(record);
+    }
+
+    candidates         = next;
+    pressed           |= bit;
+    buffer[buffered++] = record->event;
+    if (timeout == INVALID_DEFERRED_TOKEN) {
+        timeout = defer_exec(POS_COMBO_TERM, timeout_callback, NULL);
+    }
+
+    int8_t index = complete_candidate();
+
+    // fire early once no longer combo is left to wait for
+    if (index >= 0 && candidates == (1 << index)) {
+        fire(index);
+    }
+    return false;
+}
+
+static bool release(keyrecord_t *record) {
+    pos_mask_t bit     = POS_BIT(record->event.key);
+    bool       swallow = false;
+
+    if (pressed & bit) {
+        int8_t index = complete_candidate();
+
+        if (index < 0) {
+            flush();
+            return true;
+        }
+        fire(index);
+    }
+    for (uint8_t i = 0; i < POS_COMBO_MAX; i++) {
+        if (held[i] & bit) {
+            held[i] &= ~bit;
+            if (held_action[i] != KC_NO) {
+                unregister_code16(held_action[i]);
+                held_action[i] = KC_NO;
+            }
+            swallow = true;
+        }
+    }
+    return !swallow;
+}
+
+bool pos_combo_pre_process_record(keyrecord_t *record) {
+    if (replaying || record->event.type != KEY_EVENT) {
+        return true;
+    }
+    return record->event.pressed ? press(record) : release(record);
+}
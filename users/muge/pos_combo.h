@@ -0,0 +1,55 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Position-indexed combos.
+ *
+ * A keymap lists its combos by keycode in a PROGMEM pos_combos[] table, as
+ * with QMK combos. pos_combo_init() resolves every combo to a bitmask of
+ * matrix positions on each layer, so pressing a key costs one AND against
+ * the union of the combo keys on the current layer. A combo fires as soon
+ * as its keys are down and no longer combo on that layer can still
+ * complete. Otherwise it fires when POS_COMBO_TERM runs out. Presses that
+ * end up in no combo are replayed in order.
+ *
+ * The layer is the highest active one when the first key goes down. TG()
+ * actions toggle their layer. Any other action is registered until the
+ * first of the combo keys is released; combos held at the same time are
+ * released independently.
+ *
+ * At most POS_COMBO_MAX combos are used. Keymaps check their table with
+ *
+ *   _Static_assert(ARRAY_SIZE(pos_combos) <= POS_COMBO_MAX, "...");
+ */
+
+#ifndef POS_COMBO_MAX
+#    define POS_COMBO_MAX 4
+#endif
+#ifndef POS_COMBO_MAX_KEYS
+#    define POS_COMBO_MAX_KEYS 4
+#endif
+#ifndef POS_COMBO_LAYERS
+#    define POS_COMBO_LAYERS 4
+#endif
+#ifndef POS_COMBO_TERM
+#    define POS_COMBO_TERM 50
+#endif
+
+typedef struct {
+    uint16_t action;
+    uint16_t keys[POS_COMBO_MAX_KEYS]; // KC_NO terminated when shorter
+} pos_combo_t;
+
+#define POS_COMBO(action, ...) {action, {__VA_ARGS__}}
+
+// provided by the keymap
+extern const pos_combo_t pos_combos[];
+extern const uint8_t     pos_combo_count;
+
+void pos_combo_init(void);
+// Called from pre_process_record_user(); returns false for held-back events.
+bool pos_combo_pre_process_record(keyrecord_t *record);
+bool pos_combo_is_replaying(void);
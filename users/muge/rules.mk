@@ -0,0 +1,50 @@
+SRC += muge.c
+
+ifeq ($(strip $(MUGE_TAP_HOLD_ENABLE)), yes)
+    SRC += tap_hold.c
+    OPT_DEFS += -DMUGE_TAP_HOLD_ENABLE
+    DEFERRED_EXEC_ENABLE = yes
+endif
+
+ifeq ($(strip $(TAP_DANCE_ENABLE)), yes)
+    SRC += tap_dance.c
+endif
+
+ifneq ($(filter yes,$(strip $(MUGE_TAP_HOLD_ENABLE)) $(strip $(TAP_DANCE_ENABLE))),)
+    SRC += journal.c active_slot.c
+    DEFERRED_EXEC_ENABLE = yes
+endif
+
+ifeq ($(strip $(MUGE_POS_COMBO_ENABLE)), yes)
+    SRC += pos_combo.c
+    OPT_DEFS += -DMUGE_POS_COMBO_ENABLE
+    DEFERRED_EXEC_ENABLE = yes
+endif
+
+ifeq ($(strip $(MUGE_KNOB_ENABLE)), yes)
+    SRC += knob.c
+    OPT_DEFS += -DMUGE_KNOB_ENABLE
+    ENCODER_MAP_ENABLE = yes
+    DEFERRED_EXEC_ENABLE = yes
+endif
+
+ifeq ($(strip $(MUGE_BENCH_ENABLE)), yes)
+    SRC += bench.c
+    OPT_DEFS += -DMUGE_BENCH_ENABLE
+    CONSOLE_ENABLE = yes
+endif
+
+ifeq ($(strip $(MUGE_SCAN_STATS_ENABLE)), yes)
+    SRC += scan_stats.c
+    OPT_DEFS += -DMUGE_SCAN_STATS_ENABLE
+endif
+
+ifeq ($(strip $(MUGE_KEY_TRACE_ENABLE)), yes)
+    SRC += key_trace.c
+    OPT_DEFS += -DMUGE_KEY_TRACE_ENABLE
+    RAW_ENABLE = yes
+    # trace commands are taken ahead of whichever code owns raw_hid_receive();
+    # a --wrap does not reach calls that LTO has resolved inside its unit
+    EXTRALDFLAGS += -Wl,--wrap=raw_hid_receive
+    LTO_ENABLE = no
+endif
@@ -0,0 +1,52 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "scan_stats.h"
+#include "print.h"
+
+static matrix_row_t last[MATRIX_ROWS];
+static uint32_t     scans;
+static uint32_t     idle_scans;
+static uint16_t     report_timer;
+static uint16_t     idle_permille;
+static bool         from_matrix;
+
+void scan_stats_record(bool idle) {
+    from_matrix = true;
+    scans++;
+    if (idle) {
+        idle_scans++;
+    }
+}
+
+void scan_stats_task(void) {
+    if (!from_matrix) {
+        matrix_row_t delta = 0;
+
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            matrix_row_t now = matrix_get_row(row);
+
+            delta |= now ^ last[row];
+            last[row] = now;
+        }
+        scans++;
+        if (!delta) {
+            idle_scans++;
+        }
+    }
+    if (!scans || timer_elapsed(report_timer) < SCAN_STATS_REPORT_MS) {
+        return;
+    }
+
+    idle_permille = idle_scans * 1000 / scans;
+#ifdef CONSOLE_ENABLE
+    uprintf("matrix: %lu scans, %u.%u%% idle\n", scans, idle_permille / 10, idle_permille % 10);
+#endif
+    scans        = 0;
+    idle_scans   = 0;
+    report_timer = timer_read();
+}
+
+uint16_t scan_stats_idle_permille(void) {
+    return idle_permille;
+}
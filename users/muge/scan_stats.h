@@ -0,0 +1,25 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Share of matrix scans that found nothing changed.
+ *
+ * A custom matrix that already compares each scan against the last one
+ * reports it with scan_stats_record(), as the V1 Max's does from its raw
+ * port words. Otherwise the userspace XORs every matrix row against its
+ * copy from the previous loop iteration. Every SCAN_STATS_REPORT_MS
+ * milliseconds the idle-scan ratio of the period is latched for
+ * scan_stats_idle_permille() and, if the keymap enables CONSOLE_ENABLE,
+ * printed to the console (`qmk console`).
+ */
+
+#ifndef SCAN_STATS_REPORT_MS
+#    define SCAN_STATS_REPORT_MS 5000
+#endif
+
+void     scan_stats_task(void);
+void     scan_stats_record(bool idle); // once per scan, from matrix_scan_custom()
+uint16_t scan_stats_idle_permille(void); // last full period, 0 before the first
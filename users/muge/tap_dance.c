@@ -0,0 +1,195 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "tap_dance.h"
+
+/* Classifies a dance by its tap count and by whether it was interrupted or
+ * is still held. td_row_finished() maps the result onto a td_rows[] column
+ * through td_row_action(): one tap or hold, a double tap, a tap then hold,
+ * and a third tap or hold share the triple column.
+ *
+ * An interrupted double tap is TD_DOUBLE_SINGLE_TAP, which no column takes,
+ * so it sends nothing. Rows flagged TD_F_PERMISSIVE resolve a hold early in
+ * td_pre_process_record() instead of reporting an interrupt.
+ */
+td_state_t cur_dance(tap_dance_state_t *state) {
+    if (state->count == 1) {
+        if (state->interrupted || !state->pressed) return TD_SINGLE_TAP;
+        else return TD_SINGLE_HOLD;
+    } else if (state->count == 2) {
+        if (state->interrupted) return TD_DOUBLE_SINGLE_TAP;
+        else if (state->pressed) return TD_DOUBLE_HOLD;
+        else return TD_DOUBLE_TAP;
+    }
+
+    if (state->count == 3) {
+        if (state->interrupted || !state->pressed) return TD_TRIPLE_TAP;
+        else return TD_TRIPLE_HOLD;
+    } else return TD_UNKNOWN;
+}
+
+/* -----------------------
+ *  Table-driven dances
+ * -----------------------
+ */
+
+
+// permissive dance that is held and still undecided, and the events it holds back
+static const td_row_t    *td_pending;
+static tap_dance_state_t *td_pending_state;
+static keyevent_t        td_buffer[TAP_DANCE_BUFFER_SIZE];
+static uint8_t           td_buffered;
+static bool              td_replaying;
+
+static uint8_t td_row_index(const td_row_t *row) {
+    return row - td_rows;
+}
+
+static uint16_t td_row_action(const td_row_t *row, td_state_t resolved) {
+    switch (resolved) {
+        case TD_SINGLE_TAP: return pgm_read_word(&row->tap);
+        case TD_SINGLE_HOLD: return pgm_read_word(&row->hold);
+        case TD_DOUBLE_TAP: return pgm_read_word(&row->double_tap);
+        case TD_DOUBLE_HOLD: return pgm_read_word(&row->double_hold);
+        case TD_TRIPLE_TAP:
+        case TD_TRIPLE_HOLD: return pgm_read_word(&row->triple);
+        default: return KC_NO;
+    }
+}
+
+static bool td_row_single_only(const td_row_t *row) {
+    return pgm_read_word(&row->double_tap) == KC_NO && pgm_read_word(&row->double_hold) == KC_NO && pgm_read_word(&row->triple) == KC_NO;
+}
+
+// LM() stores mods in the 5-bit form, the high bit selecting right mods
+static uint8_t td_mods(uint8_t mods) {
+    return (mods & 0x10) ? (mods & 0x0F) << 4 : mods;
+}
+
+static void td_press(journal_t *journal, uint16_t keycode) {
+    if (IS_QK_MOMENTARY(keycode)) {
+        journal_layer_on(journal, QK_MOMENTARY_GET_LAYER(keycode));
+    } else if (IS_QK_LAYER_MOD(keycode)) {
+        journal_layer_on(journal, QK_LAYER_MOD_GET_LAYER(keycode));
+        journal_register_mods(journal, td_mods(QK_LAYER_MOD_GET_MODS(keycode)));
+    } else if (keycode != KC_NO) {
+        journal_register_code16(journal, keycode);
+    }
+}
+
+// Presses the row's action for the resolved state until td_row_reset(). An
+// action is dropped if no slot is free.
+static void td_resolve(const td_row_t *row, td_state_t resolved) {
+    uint16_t keycode = td_row_action(row, resolved);
+
+    if (keycode == KC_NO) {
+        return;
+    }
+
+    active_slot_t *slot = active_slot_acquire(ACTIVE_TAP_DANCE | td_row_index(row));
+
+    if (slot) {
+        td_press(&slot->journal, keycode);
+    }
+}
+
+// Replays the held-back events through the normal pipeline. The pending
+// dance is cleared first so the replayed events are not buffered again.
+static void td_flush(void) {
+    td_pending       = NULL;
+    td_pending_state = NULL;
+    td_replaying     = true;
+    for (uint8_t i = 0; i < td_buffered; i++) {
+        action_exec(td_buffer[i]);
+    }
+    td_replaying = false;
+    td_buffered  = 0;
+}
+
+static bool td_buffered_press(keypos_t key) {
+    for (uint8_t i = 0; i < td_buffered; i++) {
+        if (td_buffer[i].pressed && KEYEQ(td_buffer[i].key, key)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Resolves the pending dance as a hold on the tap count reached so far.
+static void td_force_hold(void) {
+    td_state_t resolved = td_pending_state->count == 1 ? TD_SINGLE_HOLD : td_pending_state->count == 2 ? TD_DOUBLE_HOLD : TD_TRIPLE_HOLD;
+
+    td_pending_state->finished = true;
+    td_resolve(td_pending, resolved);
+}
+
+bool td_is_replaying(void) {
+    return td_replaying;
+}
+
+bool td_pre_process_record(uint16_t keycode, keyrecord_t *record) {
+    if (td_replaying || !td_pending) {
+        return true;
+    }
+
+    // tap dance keys and non-key events keep their usual meaning
+    if (IS_QK_TAP_DANCE(keycode) || record->event.type != KEY_EVENT) {
+        td_flush();
+        return true;
+    }
+
+    if (td_buffered == TAP_DANCE_BUFFER_SIZE) {
+        td_flush();
+        return true;
+    }
+
+    bool rolled = !record->event.pressed && td_buffered_press(record->event.key);
+
+    td_buffer[td_buffered++] = record->event;
+    if (rolled) {
+        td_force_hold();
+        td_flush();
+    }
+    return false;
+}
+
+void td_row_tap(tap_dance_state_t *state, void *user_data) {
+    if (pgm_read_byte(&((const td_row_t *)user_data)->flags) & TD_F_PERMISSIVE) {
+        td_pending       = user_data;
+        td_pending_state = state;
+    }
+}
+
+void td_row_finished(tap_dance_state_t *state, void *user_data) {
+    td_resolve(user_data, cur_dance(state));
+
+    // the term ran out while the key was held, so release what it held back
+    if (td_pending == user_data) {
+        td_flush();
+    }
+}
+
+// Resolves single-tap-only rows on the first release. Marking the state
+// finished makes the tap dance engine call td_row_reset() right after this
+// returns, so the tap is pressed and released without waiting for the term.
+void td_row_release(tap_dance_state_t *state, void *user_data) {
+    if (state->finished || state->count != 1 || !td_row_single_only(user_data)) {
+        return;
+    }
+
+    td_resolve(user_data, TD_SINGLE_TAP);
+    state->finished = true;
+}
+
+void td_row_reset(tap_dance_state_t *state, void *user_data) {
+    active_slot_t *slot = active_slot_find(ACTIVE_TAP_DANCE | td_row_index(user_data));
+
+    if (slot) {
+        journal_undo(&slot->journal);
+        active_slot_release(slot);
+    }
+    if (td_pending == user_data) {
+        td_pending       = NULL;
+        td_pending_state = NULL;
+    }
+}
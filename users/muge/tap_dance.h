@@ -0,0 +1,73 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+#include "active_slot.h"
+
+/* Table-driven tap dances.
+ *
+ * A keymap describes each dance with one td_row_t in a PROGMEM td_rows[]
+ * table and registers it with ACTION_TAP_DANCE_ROW(index). One shared
+ * finished/reset pair resolves the dance with cur_dance() and presses the
+ * matching action through the journal of an active slot, which the reset
+ * undoes.
+ *
+ * Actions are keycodes: basic keycodes (with mods, e.g. C(KC_X)) are
+ * registered, MO(layer) turns the layer on and LM(layer, mods) turns the
+ * layer on and holds the mods. KC_NO does nothing.
+ *
+ * A row whose double tap, double hold and triple are all KC_NO cannot be
+ * extended by a second tap, so its single tap is sent on release instead
+ * of after the tapping term.
+ *
+ * Rows flagged TD_F_PERMISSIVE decide early while the dance key is held:
+ * other key events are buffered, and a buffered key that is pressed and
+ * released resolves the dance as a hold at once. The buffered events are
+ * then replayed in order on top of the hold. Releasing the dance key first
+ * replays them as an interrupt, which resolves the dance as a tap.
+ */
+
+#ifndef TAP_DANCE_BUFFER_SIZE
+#    define TAP_DANCE_BUFFER_SIZE 8
+#endif
+
+#define TD_F_PERMISSIVE (1 << 0)
+
+typedef enum {
+    TD_NONE,
+    TD_UNKNOWN,
+    TD_SINGLE_TAP,
+    TD_SINGLE_HOLD,
+    TD_DOUBLE_TAP,
+    TD_DOUBLE_HOLD,
+    TD_DOUBLE_SINGLE_TAP, // interrupted double tap, no td_rows[] column
+    TD_TRIPLE_TAP,
+    TD_TRIPLE_HOLD
+} td_state_t;
+
+typedef struct {
+    uint16_t tap;         // single tap
+    uint16_t hold;        // single hold
+    uint16_t double_tap;  // double tap
+    uint16_t double_hold; // tap then hold
+    uint16_t triple;      // triple tap or hold
+    uint8_t  flags;       // TD_F_*
+} td_row_t;
+
+// provided by the keymap
+extern const td_row_t td_rows[];
+
+#define ACTION_TAP_DANCE_ROW(index) \
+    { .fn = {td_row_tap, td_row_finished, td_row_reset, td_row_release}, .user_data = (void *)&td_rows[index], }
+
+td_state_t cur_dance(tap_dance_state_t *state);
+void       td_row_tap(tap_dance_state_t *state, void *user_data);
+void       td_row_finished(tap_dance_state_t *state, void *user_data);
+void       td_row_reset(tap_dance_state_t *state, void *user_data);
+void       td_row_release(tap_dance_state_t *state, void *user_data);
+
+// Called from pre_process_record_user(); returns false for buffered events.
+bool td_pre_process_record(uint16_t keycode, keyrecord_t *record);
+bool td_is_replaying(void);
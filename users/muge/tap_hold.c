@@ -0,0 +1,191 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "tap_hold.h"
+
+#ifdef TH_ADAPTIVE_TERM
+_Static_assert(TH_TERM_MAX < TH_HIST_BUCKETS * TH_HIST_BUCKET_MS, "TH_TERM_MAX must fall inside the histogram");
+
+static uint16_t       th_terms[TAP_HOLD_MAX_KEYS];
+static uint8_t        th_hist[TAP_HOLD_MAX_KEYS][TH_HIST_BUCKETS];
+static uint8_t        th_samples[TAP_HOLD_MAX_KEYS];
+static deferred_token th_flush_token = INVALID_DEFERRED_TOKEN;
+
+_Static_assert(sizeof(th_terms) <= EECONFIG_USER_DATA_SIZE, "EECONFIG_USER_DATA_SIZE too small for the learned terms");
+
+static uint16_t th_term(uint8_t index) {
+    return th_terms[index];
+}
+
+static uint32_t th_flush_callback(uint32_t trigger_time, void *cb_arg) {
+    th_flush_token = INVALID_DEFERRED_TOKEN;
+    eeconfig_update_user_datablock(th_terms, 0, sizeof(th_terms));
+    return 0;
+}
+
+// Moves the term a quarter of the way towards the least used bucket between
+// the tap peak (below the current term) and the hold peak (at or above it).
+static void th_adapt(uint8_t index) {
+    const uint8_t *hist  = th_hist[index];
+    uint16_t       term  = th_terms[index];
+    uint8_t        split = term / TH_HIST_BUCKET_MS;
+    uint8_t        tap   = 0;
+    uint8_t        hold  = split;
+
+    for (uint8_t i = 1; i < split; i++) {
+        if (hist[i] > hist[tap]) tap = i;
+    }
+    for (uint8_t i = split + 1; i < TH_HIST_BUCKETS; i++) {
+        if (hist[i] > hist[hold]) hold = i;
+    }
+    if (!hist[tap] || !hist[hold] || hold - tap < 2) {
+        return;
+    }
+
+    uint8_t valley = tap + 1;
+    for (uint8_t i = valley + 1; i < hold; i++) {
+        if (hist[i] < hist[valley]) valley = i;
+    }
+
+    int16_t target = valley * TH_HIST_BUCKET_MS + TH_HIST_BUCKET_MS / 2;
+    int16_t next   = term + (target - (int16_t)term) / 4;
+    next           = MAX(TH_TERM_MIN, MIN(TH_TERM_MAX, next));
+    if (next == term) {
+        return;
+    }
+    th_terms[index] = next;
+    if (th_flush_token == INVALID_DEFERRED_TOKEN) {
+        th_flush_token = defer_exec(TH_FLUSH_DELAY, th_flush_callback, NULL);
+    }
+}
+
+static void th_learn(uint8_t index, uint16_t duration) {
+    uint8_t *hist   = th_hist[index];
+    uint8_t  bucket = MIN(duration / TH_HIST_BUCKET_MS, TH_HIST_BUCKETS - 1);
+
+    // halving keeps the counts in a byte and lets old habits fade out
+    if (++hist[bucket] == UINT8_MAX) {
+        for (uint8_t i = 0; i < TH_HIST_BUCKETS; i++) {
+            hist[i] >>= 1;
+        }
+    }
+    if (++th_samples[index] >= TH_ADAPT_SAMPLES) {
+        th_samples[index] = 0;
+        th_adapt(index);
+    }
+}
+
+void tap_hold_init(void) {
+    eeconfig_read_user_datablock(th_terms, 0, sizeof(th_terms));
+    for (uint8_t i = 0; i < th_key_count; i++) {
+        if (th_terms[i] < TH_TERM_MIN || th_terms[i] > TH_TERM_MAX) {
+            th_terms[i] = pgm_read_word(&th_keys[i].term);
+        }
+    }
+}
+#else
+static uint16_t th_term(uint8_t index) {
+    return pgm_read_word(&th_keys[index].term);
+}
+
+void tap_hold_init(void) {}
+#endif
+
+static void th_send(uint8_t keycode, uint8_t mods) {
+    if (keycode == KC_NO) {
+        return;
+    }
+    if (mods) {
+        register_mods(mods);
+    }
+    tap_code(keycode);
+    if (mods) {
+        unregister_mods(mods);
+    }
+}
+
+static uint32_t th_hold_callback(uint32_t trigger_time, void *cb_arg) {
+    active_slot_t *slot  = cb_arg;
+    uint8_t        index = ACTIVE_SLOT_INDEX(slot->owner);
+
+    th_send(pgm_read_byte(&th_keys[index].hold), pgm_read_byte(&th_keys[index].hold_mods));
+    if (!(pgm_read_byte(&th_keys[index].flags) & TH_F_REPEAT)) {
+        slot->token = INVALID_DEFERRED_TOKEN;
+        slot->held  = true;
+        return 0;
+    }
+
+    // returning a delay reschedules this executor under the same token
+    if (!slot->held) {
+        slot->held     = true;
+        slot->interval = TH_REPEAT_INTERVAL;
+        return TH_REPEAT_DELAY;
+    }
+    uint16_t delay = slot->interval;
+    slot->interval = MAX(TH_REPEAT_INTERVAL_MIN, slot->interval * TH_REPEAT_ACCEL / 100);
+    return delay;
+}
+
+static void th_release(const th_key_t *key, active_slot_t *slot, uint16_t duration) {
+    if (key->flags & TH_F_INSTANT) {
+        journal_undo(&slot->journal);
+        if (duration < key->term) {
+            th_send(key->tap, key->tap_mods);
+        }
+        return;
+    }
+
+    if (slot->token != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(slot->token);
+        slot->token = INVALID_DEFERRED_TOKEN;
+    }
+    if (slot->held) {
+        return;
+    }
+    if (duration < key->term) {
+        th_send(key->tap, key->tap_mods);
+    } else {
+        th_send(key->hold, key->hold_mods);
+    }
+}
+
+bool process_tap_hold(uint8_t index, keyrecord_t *record) {
+    if (index >= th_key_count || index >= TAP_HOLD_MAX_KEYS) {
+        return true;
+    }
+
+    th_key_t key;
+
+    memcpy_P(&key, &th_keys[index], sizeof(key));
+    key.term = th_term(index);
+    if (record->event.pressed) {
+        active_slot_t *slot = active_slot_acquire(ACTIVE_TAP_HOLD | index);
+
+        // without a slot the key degrades to a plain tap on release
+        if (!slot) {
+            return false;
+        }
+        if (key.flags & TH_F_INSTANT) {
+            if (key.layer != TH_NO_LAYER) journal_layer_on(&slot->journal, key.layer);
+            if (key.hold_mods) journal_register_mods(&slot->journal, key.hold_mods);
+        } else if ((key.flags & TH_F_EAGER) && key.hold != KC_NO) {
+            slot->token = defer_exec(key.term, th_hold_callback, slot);
+        }
+        return false;
+    }
+
+    active_slot_t *slot = active_slot_find(ACTIVE_TAP_HOLD | index);
+
+    if (!slot) {
+        th_send(key.tap, key.tap_mods);
+        return false;
+    }
+
+    uint16_t duration = timer_elapsed(slot->timer);
+#ifdef TH_ADAPTIVE_TERM
+    th_learn(index, duration);
+#endif
+    th_release(&key, slot, duration);
+    active_slot_release(slot);
+    return false;
+}
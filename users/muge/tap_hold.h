@@ -0,0 +1,94 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+#include "active_slot.h"
+
+/* Dual-function (tap-hold) keys.
+ *
+ * A tap-hold key taps one shortcut when released within its term and sends
+ * another when held past it. Each keymap describes its keys with one th_key_t
+ * row per key in a PROGMEM th_keys[] table and forwards presses with
+ * process_tap_hold(), passing the row index (usually `keycode - TH_FIRST`).
+ *
+ * TH_F_EAGER   sends the hold action as soon as the term expires while the key
+ *              is still down; a release before the term cancels it.
+ * TH_F_REPEAT  keeps sending the hold action while held, first after
+ *              TH_REPEAT_DELAY and then at an interval that shrinks towards
+ *              TH_REPEAT_INTERVAL_MIN.
+ * TH_F_INSTANT engages the row's layer and hold mods on press and drops them
+ *              on release; the tap is still only sent for a short press.
+ *
+ * With TH_ADAPTIVE_TERM the term in th_keys[] is only the starting point. Each
+ * key keeps a histogram of its press durations and its term is nudged towards
+ * the valley between the tap and the hold peaks. The learned terms are written
+ * to the user EEPROM datablock in batches.
+ */
+
+// upper bound for th_key_count, sizes the learned terms and histograms
+#ifndef TAP_HOLD_MAX_KEYS
+#    define TAP_HOLD_MAX_KEYS 16
+#endif
+
+// auto-repeat of TH_F_REPEAT hold actions, all in ms
+#ifndef TH_REPEAT_DELAY
+#    define TH_REPEAT_DELAY 250 // first hold action to first repeat
+#endif
+#ifndef TH_REPEAT_INTERVAL
+#    define TH_REPEAT_INTERVAL 100 // initial repeat interval
+#endif
+#ifndef TH_REPEAT_INTERVAL_MIN
+#    define TH_REPEAT_INTERVAL_MIN 20 // fastest repeat interval
+#endif
+#ifndef TH_REPEAT_ACCEL
+#    define TH_REPEAT_ACCEL 80 // percent of the interval kept after each repeat
+#endif
+
+#ifdef TH_ADAPTIVE_TERM
+#    ifndef TH_TERM_MIN
+#        define TH_TERM_MIN 100
+#    endif
+#    ifndef TH_TERM_MAX
+#        define TH_TERM_MAX 250
+#    endif
+#    ifndef TH_HIST_BUCKETS
+#        define TH_HIST_BUCKETS 16
+#    endif
+#    ifndef TH_HIST_BUCKET_MS
+#        define TH_HIST_BUCKET_MS 20
+#    endif
+#    ifndef TH_ADAPT_SAMPLES
+#        define TH_ADAPT_SAMPLES 16 // presses between two term updates
+#    endif
+#    ifndef TH_FLUSH_DELAY
+#        define TH_FLUSH_DELAY 60000 // batch EEPROM writes, ms after the first change
+#    endif
+#endif
+
+#define TH_F_EAGER (1 << 0)   // fire the hold action at the term, not on release
+#define TH_F_REPEAT (1 << 1)  // keep repeating the hold action while held
+#define TH_F_INSTANT (1 << 2) // engage layer and hold mods from the press on
+
+#define TH_NO_LAYER 0xFF
+
+typedef struct {
+    uint8_t  tap;       // basic keycode sent on tap
+    uint8_t  tap_mods;  // MOD_BIT() mask held around the tap keycode
+    uint8_t  hold;      // basic keycode sent on hold, KC_NO for none
+    uint8_t  hold_mods; // MOD_BIT() mask held around the hold keycode
+    uint8_t  layer;     // layer held with TH_F_INSTANT, TH_NO_LAYER for none
+    uint8_t  flags;     // TH_F_* behaviour flags
+    uint16_t term;      // tap/hold threshold in ms
+} th_key_t;
+
+#define TAP_HOLD(tap, tap_mods, hold, hold_mods, flags, term) {tap, tap_mods, hold, hold_mods, TH_NO_LAYER, flags, term}
+#define TAP_HOLD_LAYER(tap, layer, mods, term) {tap, 0, KC_NO, mods, layer, TH_F_INSTANT, term}
+
+// provided by the keymap
+extern const th_key_t th_keys[];
+extern const uint8_t  th_key_count;
+
+void tap_hold_init(void);
+bool process_tap_hold(uint8_t index, keyrecord_t *record);
@@ -0,0 +1,492 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+#define MAX_DEFERRED 8
+#define LOG_SIZE 1024
+#define MAX_CODE16 8
+
+typedef struct {
+    deferred_token         token;
+    uint32_t               trigger;
+    deferred_exec_callback callback;
+    void                  *cb_arg;
+} deferred_t;
+
+static uint32_t   now;
+static deferred_t deferred[MAX_DEFERRED];
+static uint8_t    last_token;
+
+static char log_text[LOG_SIZE];
+static int  log_len;
+
+// keyboard reports as the host sees them, and the last one sent
+static char report_text[LOG_SIZE];
+static int  report_len;
+static char last_report[64] = "[]";
+static bool reports_checked;
+
+// what is down on the host, for the stuck-key check
+static uint8_t  codes_down[256];
+static uint8_t  mods_down;
+static uint16_t code16_down[MAX_CODE16];
+
+static int         failures;
+static int         tests;
+static const char *current;
+static bool        current_failed;
+
+uint8_t harness_eeprom[EECONFIG_USER_DATA_SIZE];
+uint8_t harness_eeprom_writes;
+bool    harness_quiet;
+
+layer_state_t layer_state;
+layer_state_t default_layer_state = 1;
+
+/* Failures */
+
+static void fail(const char *file, int line, const char *fmt, ...) {
+    va_list args;
+
+    fprintf(stderr, "%s:%d: %s: ", file, line, current ? current : "(setup)");
+    va_start(args, fmt);
+    vfprintf(stderr, fmt, args);
+    va_end(args);
+    fputc('\n', stderr);
+    current_failed = true;
+}
+
+void harness_expect(const char *file, int line, const char *what, bool ok) {
+    if (!ok) {
+        fail(file, line, "expected %s", what);
+    }
+}
+
+/* Log */
+
+void harness_log(const char *fmt, ...) {
+    va_list args;
+
+    if (harness_quiet) {
+        return;
+    }
+    if (log_len && log_len < LOG_SIZE - 1) {
+        log_text[log_len++] = ' ';
+    }
+    va_start(args, fmt);
+    log_len += vsnprintf(log_text + log_len, LOG_SIZE - log_len, fmt, args);
+    va_end(args);
+    if (log_len >= LOG_SIZE) {
+        log_len = LOG_SIZE - 1;
+    }
+}
+
+void harness_expect_log(const char *file, int line, const char *expected) {
+    if (strcmp(log_text, expected)) {
+        fail(file, line, "log\n    got:      \"%s\"\n    expected: \"%s\"", log_text, expected);
+    }
+    log_len     = 0;
+    log_text[0] = '\0';
+}
+
+void harness_expect_reports(const char *file, int line, const char *expected) {
+    if (strcmp(report_text, expected)) {
+        fail(file, line, "reports\n    got:      \"%s\"\n    expected: \"%s\"", report_text, expected);
+    }
+    report_len      = 0;
+    report_text[0]  = '\0';
+    reports_checked = true;
+}
+
+void harness_discard(void) {
+    log_len        = 0;
+    log_text[0]    = '\0';
+    report_len     = 0;
+    report_text[0] = '\0';
+}
+
+uint64_t harness_now_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+
+static const char *kc_name(uint8_t keycode) {
+    static char buf[8];
+
+    if (keycode >= KC_A && keycode <= KC_Z) {
+        buf[0] = 'A' + keycode - KC_A;
+        buf[1] = '\0';
+        return buf;
+    }
+    if (keycode >= KC_1 && keycode <= KC_0) {
+        buf[0] = keycode == KC_0 ? '0' : '1' + keycode - KC_1;
+        buf[1] = '\0';
+        return buf;
+    }
+    if (keycode >= KC_F1 && keycode <= KC_F12) {
+        snprintf(buf, sizeof(buf), "F%u", keycode - KC_F1 + 1);
+        return buf;
+    }
+    switch (keycode) {
+        case KC_ESC: return "ESC";
+        case KC_GRV: return "GRV";
+        case KC_DEL: return "DEL";
+        case KC_BSPC: return "BSPC";
+        case KC_TAB: return "TAB";
+        case KC_SPC: return "SPC";
+        case KC_CAPS: return "CAPS";
+        case KC_LEFT: return "LEFT";
+        case KC_PGUP: return "PGUP";
+        case KC_PGDN: return "PGDN";
+        case KC_VOLU: return "VOLU";
+        case KC_VOLD: return "VOLD";
+        case KC_LCTL: return "LCTL";
+        case KC_LSFT: return "LSFT";
+        case KC_LALT: return "LALT";
+        case KC_LGUI: return "LGUI";
+    }
+    snprintf(buf, sizeof(buf), "%02X", keycode);
+    return buf;
+}
+
+static const char *mods_name(uint8_t mods) {
+    static const char *names[] = {"LCTL", "LSFT", "LALT", "LGUI", "RCTL", "RSFT", "RALT", "RGUI"};
+    static char        buf[48];
+
+    buf[0] = '\0';
+    for (uint8_t i = 0; i < 8; i++) {
+        if (mods & (1 << i)) {
+            if (buf[0]) strcat(buf, "|");
+            strcat(buf, names[i]);
+        }
+    }
+    return buf;
+}
+
+static const char *kc16_name(uint16_t keycode) {
+    static const char prefix[] = {'C', 'S', 'A', 'G'};
+    static char       buf[24];
+    uint8_t           mods = (keycode >> 8) & 0x0F;
+    int               len  = 0;
+
+    if (keycode <= 0xFF) {
+        return kc_name(keycode);
+    }
+    for (uint8_t i = 0; i < 4; i++) {
+        if (mods & (1 << i)) len += snprintf(buf + len, sizeof(buf) - len, "%c(", prefix[i]);
+    }
+    len += snprintf(buf + len, sizeof(buf) - len, "%s", kc_name(keycode));
+    for (uint8_t i = 0; i < 4; i++) {
+        if (mods & (1 << i)) len += snprintf(buf + len, sizeof(buf) - len, ")");
+    }
+    return buf;
+}
+
+/* Time */
+
+uint16_t timer_read(void) {
+    return (uint16_t)now;
+}
+
+uint32_t timer_read32(void) {
+    return now;
+}
+
+uint16_t timer_elapsed(uint16_t last) {
+    return (uint16_t)(now - last);
+}
+
+uint32_t timer_elapsed32(uint32_t last) {
+    return now - last;
+}
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    for (uint8_t i = 0; i < MAX_DEFERRED; i++) {
+        if (deferred[i].token == INVALID_DEFERRED_TOKEN) {
+            if (++last_token == INVALID_DEFERRED_TOKEN) ++last_token;
+            deferred[i] = (deferred_t){last_token, now + delay_ms, callback, cb_arg};
+            return last_token;
+        }
+    }
+    return INVALID_DEFERRED_TOKEN;
+}
+
+bool extend_deferred_exec(deferred_token token, uint32_t delay_ms) {
+    for (uint8_t i = 0; token && i < MAX_DEFERRED; i++) {
+        if (deferred[i].token == token) {
+            deferred[i].trigger = now + delay_ms;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool cancel_deferred_exec(deferred_token token) {
+    for (uint8_t i = 0; token && i < MAX_DEFERRED; i++) {
+        if (deferred[i].token == token) {
+            deferred[i].token = INVALID_DEFERRED_TOKEN;
+            return true;
+        }
+    }
+    return false;
+}
+
+void harness_tick(uint32_t ms) {
+    while (ms--) {
+        now++;
+        for (uint8_t i = 0; i < MAX_DEFERRED; i++) {
+            deferred_t    *entry = &deferred[i];
+            deferred_token token = entry->token;
+
+            if (token == INVALID_DEFERRED_TOKEN || now < entry->trigger) {
+                continue;
+            }
+
+            uint32_t delay = entry->callback(entry->trigger, entry->cb_arg);
+
+            // the callback may have cancelled itself
+            if (entry->token != token) {
+                continue;
+            }
+            if (delay) {
+                entry->trigger += delay;
+            } else {
+                entry->token = INVALID_DEFERRED_TOKEN;
+            }
+        }
+    }
+}
+
+bool harness_pending(void) {
+    for (uint8_t i = 0; i < MAX_DEFERRED; i++) {
+        if (deferred[i].token != INVALID_DEFERRED_TOKEN) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* Events */
+
+keyrecord_t harness_key(uint8_t row, uint8_t col, bool pressed) {
+    return (keyrecord_t){.event = {.key = {.col = col, .row = row}, .time = timer_read(), .type = KEY_EVENT, .pressed = pressed}};
+}
+
+keyrecord_t harness_encoder(uint8_t index, bool clockwise) {
+    return (keyrecord_t){.event = {.key = {.col = index, .row = clockwise ? 0xFF : 0xFE}, .time = timer_read(), .type = clockwise ? ENCODER_CW_EVENT : ENCODER_CCW_EVENT, .pressed = true}};
+}
+
+/* Host side */
+
+/* Keyboard reports
+ *
+ * Modifier keycodes and the mods of 16-bit keycodes fold into the mods byte,
+ * consumer and mouse keycodes go to their own reports and are left out. As in
+ * QMK, a report that matches the last one sent is not sent again.
+ */
+static void send_report(void) {
+    char    report[sizeof(last_report)];
+    uint8_t mods = mods_down;
+    int     len;
+
+    if (harness_quiet) {
+        return;
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        if (codes_down[KC_LCTL + i]) mods |= 1 << i;
+    }
+    for (uint8_t i = 0; i < MAX_CODE16; i++) {
+        uint8_t code_mods = (code16_down[i] >> 8) & 0x0F;
+
+        mods |= code16_down[i] & 0x1000 ? code_mods << 4 : code_mods;
+    }
+    len = snprintf(report, sizeof(report), "[%s", mods_name(mods));
+    for (int code = KC_A; code < KC_AUDIO_MUTE; code++) {
+        bool down = codes_down[code];
+
+        for (uint8_t i = 0; i < MAX_CODE16 && !down; i++) {
+            down = code16_down[i] && (code16_down[i] & 0xFF) == code;
+        }
+        if (down) {
+            len += snprintf(report + len, sizeof(report) - len, "%s%s", len > 1 ? " " : "", kc_name(code));
+        }
+    }
+    snprintf(report + len, sizeof(report) - len, "]");
+
+    if (!strcmp(report, last_report)) {
+        return;
+    }
+    strcpy(last_report, report);
+    if (report_len && report_len < LOG_SIZE - 1) {
+        report_text[report_len++] = ' ';
+    }
+    report_len += snprintf(report_text + report_len, LOG_SIZE - report_len, "%s", report);
+    if (report_len >= LOG_SIZE) {
+        report_len = LOG_SIZE - 1;
+    }
+}
+
+void register_code(uint8_t keycode) {
+    codes_down[keycode]++;
+    harness_log("+%s", kc_name(keycode));
+    send_report();
+}
+
+void unregister_code(uint8_t keycode) {
+    if (codes_down[keycode]) codes_down[keycode]--;
+    harness_log("-%s", kc_name(keycode));
+    send_report();
+}
+
+void tap_code(uint8_t keycode) {
+    register_code(keycode);
+    unregister_code(keycode);
+}
+
+void register_code16(uint16_t keycode) {
+    if (keycode <= 0xFF) {
+        register_code(keycode);
+        return;
+    }
+    for (uint8_t i = 0; i < MAX_CODE16; i++) {
+        if (!code16_down[i]) {
+            code16_down[i] = keycode;
+            break;
+        }
+    }
+    harness_log("+%s", kc16_name(keycode));
+    send_report();
+}
+
+void unregister_code16(uint16_t keycode) {
+    if (keycode <= 0xFF) {
+        unregister_code(keycode);
+        return;
+    }
+    for (uint8_t i = 0; i < MAX_CODE16; i++) {
+        if (code16_down[i] == keycode) {
+            code16_down[i] = 0;
+            break;
+        }
+    }
+    harness_log("-%s", kc16_name(keycode));
+    send_report();
+}
+
+void tap_code16(uint16_t keycode) {
+    register_code16(keycode);
+    unregister_code16(keycode);
+}
+
+void register_mods(uint8_t mods) {
+    mods_down |= mods;
+    harness_log("+%s", mods_name(mods));
+    send_report();
+}
+
+void unregister_mods(uint8_t mods) {
+    mods_down &= ~mods;
+    harness_log("-%s", mods_name(mods));
+    send_report();
+}
+
+void host_consumer_send(uint16_t usage) {
+    harness_log("usage:%04X", usage);
+}
+
+__attribute__((weak)) void action_exec(keyevent_t event) {
+    harness_log("exec:%u,%u%c", event.key.row, event.key.col, event.pressed ? '+' : '-');
+}
+
+/* Layers */
+
+uint8_t get_highest_layer(layer_state_t state) {
+    uint8_t layer = 0;
+
+    while (state >>= 1) {
+        layer++;
+    }
+    return layer;
+}
+
+void layer_on(uint8_t layer) {
+    layer_state |= (layer_state_t)1 << layer;
+    harness_log("L%u+", layer);
+}
+
+void layer_off(uint8_t layer) {
+    layer_state &= ~((layer_state_t)1 << layer);
+    harness_log("L%u-", layer);
+}
+
+void layer_invert(uint8_t layer) {
+    if (layer_state & ((layer_state_t)1 << layer)) {
+        layer_off(layer);
+    } else {
+        layer_on(layer);
+    }
+}
+
+/* EEPROM */
+
+void eeconfig_read_user_datablock(void *data, uint8_t offset, uint8_t size) {
+    memcpy(data, harness_eeprom + offset, size);
+}
+
+void eeconfig_update_user_datablock(const void *data, uint8_t offset, uint8_t size) {
+    memcpy(harness_eeprom + offset, data, size);
+    harness_eeprom_writes++;
+}
+
+/* Runner */
+
+void harness_run(const char *name, harness_test_fn fn) {
+    current        = name;
+    current_failed = false;
+    fn();
+
+    // nothing may be left down, pending or unchecked
+    for (int i = 0; i < 256; i++) {
+        if (codes_down[i]) fail(__FILE__, __LINE__, "%s still registered", kc_name(i));
+    }
+    for (int i = 0; i < MAX_CODE16; i++) {
+        if (code16_down[i]) fail(__FILE__, __LINE__, "%s still registered", kc16_name(code16_down[i]));
+    }
+    if (mods_down) fail(__FILE__, __LINE__, "%s still held", mods_name(mods_down));
+    if (layer_state) fail(__FILE__, __LINE__, "layers %08X still on", layer_state);
+    if (harness_pending()) fail(__FILE__, __LINE__, "deferred callback still pending");
+    if (log_len) fail(__FILE__, __LINE__, "unchecked log \"%s\"", log_text);
+    if (reports_checked && report_len) fail(__FILE__, __LINE__, "unchecked reports \"%s\"", report_text);
+
+    memset(codes_down, 0, sizeof(codes_down));
+    memset(code16_down, 0, sizeof(code16_down));
+    memset(deferred, 0, sizeof(deferred));
+    mods_down       = 0;
+    layer_state     = 0;
+    log_len         = 0;
+    log_text[0]     = '\0';
+    report_len      = 0;
+    report_text[0]  = '\0';
+    reports_checked = false;
+    strcpy(last_report, "[]");
+    // a gap between tests keeps timing state from leaking into the next one
+    now += 10000;
+
+    tests++;
+    if (current_failed) {
+        failures++;
+        printf("FAIL %s\n", name);
+    }
+    current = NULL;
+}
+
+int harness_summary(void) {
+    printf("%d/%d passed\n", tests - failures, tests);
+    return failures ? 1 : 0;
+}
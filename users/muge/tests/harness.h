@@ -0,0 +1,61 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Minimal host test harness.
+ *
+ * Time only moves through harness_tick(), one millisecond at a time, and
+ * runs deferred callbacks as they come due, as deferred_exec_task() would
+ * once per scan. Everything sent to the host or the layer stack lands in a
+ * space-separated log:
+ *
+ *   +A -A           key A registered, unregistered (a tap is both)
+ *   +C(X) -C(X)     16-bit keycode with mods
+ *   +LALT -LALT     register_mods() / unregister_mods()
+ *   L1+ L1-         layer 1 on, off
+ *   usage:00E9      host_consumer_send()
+ *   exec:0,1+       action_exec() of a press at row 0, col 1 (tests that run
+ *                   a pipeline override action_exec() to feed it instead)
+ *
+ * The keyboard reports those calls add up to land in a second log, one
+ * [mods keys] entry per report the host would receive, so a Ctrl+J tap reads
+ * "[LCTL] [LCTL J] [LCTL] []". Tests that check it with EXPECT_REPORTS() must
+ * account for every report they cause.
+ *
+ * Each test must leave no key, mod or layer down and no callback pending;
+ * RUN_TEST() fails it otherwise.
+ */
+
+typedef void (*harness_test_fn)(void);
+
+void harness_tick(uint32_t ms);
+bool harness_pending(void);
+
+keyrecord_t harness_key(uint8_t row, uint8_t col, bool pressed);
+keyrecord_t harness_encoder(uint8_t index, bool clockwise);
+
+void harness_log(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+void harness_expect_log(const char *file, int line, const char *expected);
+void harness_expect_reports(const char *file, int line, const char *expected);
+void harness_discard(void);
+void harness_expect(const char *file, int line, const char *what, bool ok);
+void harness_run(const char *name, harness_test_fn fn);
+int  harness_summary(void);
+
+// monotonic host clock, for the bench modes
+uint64_t harness_now_ns(void);
+
+// set by tests that read the EEPROM user datablock back
+extern uint8_t harness_eeprom[EECONFIG_USER_DATA_SIZE];
+extern uint8_t harness_eeprom_writes;
+
+// skips the logs, so the bench modes time the engines rather than snprintf()
+extern bool harness_quiet;
+
+#define EXPECT_LOG(expected) harness_expect_log(__FILE__, __LINE__, expected)
+#define EXPECT_REPORTS(expected) harness_expect_reports(__FILE__, __LINE__, expected)
+#define EXPECT(cond) harness_expect(__FILE__, __LINE__, #cond, (cond))
+#define RUN_TEST(fn) harness_run(#fn, fn)
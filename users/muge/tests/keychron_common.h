@@ -0,0 +1,30 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Stand-in for keyboards/keychron/common/keychron_common.h: the keycodes the
+ * Keychron keymaps use and the hook they chain to, which passes every key on.
+ */
+
+enum {
+    KC_LOPTN = QK_KB_0,
+    KC_ROPTN,
+    KC_LCMMD,
+    KC_RCMMD,
+    KC_MCTRL,
+    KC_LNPAD,
+    KC_TASK,
+    KC_FILE,
+    BT_HST1,
+    BT_HST2,
+    BT_HST3,
+    P2P4G,
+    BAT_LVL,
+};
+
+static inline bool process_record_keychron_common(uint16_t keycode, keyrecord_t *record) {
+    return true;
+}
@@ -0,0 +1,99 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "keymap_host.h"
+#include "harness.h"
+#include <stdio.h>
+
+static uint16_t pressed_keycodes[MATRIX_ROWS][MATRIX_COLS];
+
+static uint64_t bench_calls;
+static uint64_t bench_sum;
+static uint64_t bench_max;
+
+static uint16_t keycode_at(keypos_t key) {
+    layer_state_t layers = layer_state | default_layer_state;
+
+    for (int8_t layer = keymap_layer_count() - 1; layer >= 0; layer--) {
+        if (layers & ((layer_state_t)1 << layer)) {
+            uint16_t keycode = keymap_key_to_keycode(layer, key);
+
+            if (keycode != KC_TRNS) {
+                return keycode;
+            }
+        }
+    }
+    return KC_NO;
+}
+
+// keys of the keyboard report; consumer and mouse keycodes sit in between
+static bool is_report_key(uint16_t keycode) {
+    uint8_t code = keycode & 0xFF;
+
+    return keycode <= QK_MODS_MAX && ((code >= KC_A && code < KC_AUDIO_MUTE) || code >= KC_LCTL);
+}
+
+static void process_action(uint16_t keycode, bool pressed) {
+    if (is_report_key(keycode)) {
+        if (pressed) {
+            register_code16(keycode);
+        } else {
+            unregister_code16(keycode);
+        }
+    } else if (IS_QK_MOMENTARY(keycode)) {
+        if (pressed) {
+            layer_on(QK_MOMENTARY_GET_LAYER(keycode));
+        } else {
+            layer_off(QK_MOMENTARY_GET_LAYER(keycode));
+        }
+    } else if (IS_QK_TOGGLE_LAYER(keycode) && pressed) {
+        layer_invert(QK_TOGGLE_LAYER_GET_LAYER(keycode));
+    }
+}
+
+static void process_event(keyevent_t event, uint16_t keycode) {
+    keyrecord_t record = {.event = event};
+    uint16_t   *cached = &pressed_keycodes[event.key.row][event.key.col];
+
+    if (event.pressed) {
+        *cached = keycode ? keycode : keycode_at(event.key);
+    }
+    keycode = *cached;
+
+    if (!pre_process_record_user(keycode, &record)) {
+        return;
+    }
+
+    uint64_t start = harness_now_ns();
+    bool     ret   = process_record_user(keycode, &record);
+    uint64_t ns    = harness_now_ns() - start;
+
+    bench_calls++;
+    bench_sum += ns;
+    bench_max = MAX(bench_max, ns);
+    if (ret) {
+        process_action(keycode, event.pressed);
+    }
+}
+
+// combos replay held-back presses through here
+void action_exec(keyevent_t event) {
+    process_event(event, KC_NO);
+}
+
+void keymap_host_key(uint8_t row, uint8_t col, uint16_t keycode, bool pressed) {
+    process_event(harness_key(row, col, pressed).event, keycode);
+}
+
+void keymap_host_bench(const char *name, uint8_t row, uint8_t col, uint16_t keycode, uint16_t hold_ms, uint16_t rounds) {
+    bench_calls = bench_sum = bench_max = 0;
+    harness_quiet = true;
+    for (uint16_t i = 0; i < rounds; i++) {
+        keymap_host_key(row, col, keycode, true);
+        harness_tick(hold_ms);
+        keymap_host_key(row, col, keycode, false);
+        harness_tick(50);
+    }
+    harness_quiet = false;
+    printf("%-24s %6llu calls  mean %5llu ns  max %6llu ns\n", name, (unsigned long long)bench_calls, (unsigned long long)(bench_calls ? bench_sum / bench_calls : 0), (unsigned long long)bench_max);
+}
@@ -0,0 +1,27 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* The slice of quantum/action.c the keymap tests need.
+ *
+ * Those tests #include a real keymap.c the way QMK's keymap introspection
+ * does. An event is looked up on the layer stack, goes through the userspace
+ * pre_process_record_user() and process_record_user(), and whatever they let
+ * through registers basic and modded keycodes or follows MO() and TG(). A
+ * release reuses the keycode its press resolved to, as the source layer cache
+ * does. Other keycodes are looked up but not acted on.
+ */
+
+void keyboard_post_init_user(void);
+bool pre_process_record_user(uint16_t keycode, keyrecord_t *record);
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
+
+// KC_NO looks the key up in the keymap, anything else stands in for it
+void keymap_host_key(uint8_t row, uint8_t col, uint16_t keycode, bool pressed);
+
+// Times process_record_user() over `rounds` presses held for `hold_ms` each
+// and prints the mean and worst call in ns.
+void keymap_host_bench(const char *name, uint8_t row, uint8_t col, uint16_t keycode, uint16_t hold_ms, uint16_t rounds);
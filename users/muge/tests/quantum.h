@@ -0,0 +1,281 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+/* Host stand-in for the parts of the QMK core the userspace engines use.
+ *
+ * Keycode values follow QMK where it matters (basic, mods, layer and tap
+ * dance ranges). Everything an engine sends to the host or the layer stack
+ * is appended to a text log by harness.c, which the tests compare against.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+#ifndef MATRIX_ROWS
+#    define MATRIX_ROWS 2
+#endif
+#ifndef MATRIX_COLS
+#    define MATRIX_COLS 4
+#endif
+#ifndef NUM_ENCODERS
+#    define NUM_ENCODERS 1
+#endif
+#ifndef EECONFIG_USER_DATA_SIZE
+#    define EECONFIG_USER_DATA_SIZE 32
+#endif
+
+#define PROGMEM
+#define pgm_read_byte(p) (*(const uint8_t *)(p))
+#define pgm_read_word(p) (*(const uint16_t *)(p))
+#define memcpy_P memcpy
+
+#ifndef MIN
+#    define MIN(a, b) ((a) < (b) ? (a) : (b))
+#endif
+#ifndef MAX
+#    define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+
+/* Keycodes */
+
+enum {
+    KC_NO   = 0x0000,
+    KC_TRNS = 0x0001,
+    KC_A    = 0x0004,
+    KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J, KC_K, KC_L, KC_M,
+    KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T, KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z,
+    KC_1, KC_2, KC_3, KC_4, KC_5, KC_6, KC_7, KC_8, KC_9, KC_0,
+    KC_ENT, KC_ESC, KC_BSPC, KC_TAB, KC_SPC, KC_MINS, KC_EQL, KC_LBRC, KC_RBRC, KC_BSLS,
+    KC_SCLN = 0x0033,
+    KC_QUOT, KC_GRV, KC_COMM, KC_DOT, KC_SLSH, KC_CAPS,
+    KC_F1, KC_F2, KC_F3, KC_F4, KC_F5, KC_F6, KC_F7, KC_F8, KC_F9, KC_F10, KC_F11, KC_F12,
+    KC_PSCR, KC_SCRL, KC_PAUS, KC_INS, KC_HOME, KC_PGUP, KC_DEL, KC_END, KC_PGDN,
+    KC_RGHT, KC_LEFT, KC_DOWN, KC_UP,
+    KC_PSLS = 0x0054,
+    KC_PAST,
+    KC_APP  = 0x0065,
+    KC_AUDIO_MUTE     = 0x00A8,
+    KC_AUDIO_VOL_UP   = 0x00A9,
+    KC_AUDIO_VOL_DOWN = 0x00AA,
+    KC_MNXT, KC_MPRV, KC_MSTP, KC_MPLY,
+    KC_CALC = 0x00B2,
+    KC_BRIU = 0x00BD,
+    KC_BRID,
+    MS_UP   = 0x00CD,
+    MS_DOWN, MS_LEFT, MS_RGHT, MS_BTN1, MS_BTN2, MS_BTN3,
+    MS_WHLU = 0x00D9,
+    MS_WHLD = 0x00DA,
+    MS_WHLL = 0x00DB,
+    MS_WHLR = 0x00DC,
+    KC_LCTL = 0x00E0,
+    KC_LSFT, KC_LALT, KC_LGUI, KC_RCTL, KC_RSFT, KC_RALT, KC_RGUI,
+};
+
+#define _______ KC_TRNS
+#define KC_RIGHT KC_RGHT
+#define KC_BTN1 MS_BTN1
+#define KC_BTN2 MS_BTN2
+#define KC_MS_U MS_UP
+#define KC_MS_D MS_DOWN
+#define KC_MS_L MS_LEFT
+#define KC_MS_RIGHT MS_RGHT
+#define KC_VOLU KC_AUDIO_VOL_UP
+#define KC_VOLD KC_AUDIO_VOL_DOWN
+#define KC_MUTE KC_AUDIO_MUTE
+
+#define IS_CONSUMER_KEYCODE(kc) ((kc) >= KC_AUDIO_MUTE && (kc) <= KC_AUDIO_VOL_DOWN)
+#define KEYCODE2CONSUMER(kc) ((kc) == KC_AUDIO_MUTE ? 0x00E2 : (kc) == KC_AUDIO_VOL_UP ? 0x00E9 : 0x00EA)
+
+#define MOD_LCTL 0x01
+#define MOD_LSFT 0x02
+#define MOD_LALT 0x04
+#define MOD_LGUI 0x08
+#define MOD_BIT(kc) ((uint8_t)(1 << ((kc) & 0x07)))
+
+#define QK_LCTL 0x0100
+#define QK_LSFT 0x0200
+#define QK_LALT 0x0400
+#define QK_LGUI 0x0800
+#define QK_MODS_MAX 0x1FFF
+#define LCTL(kc) (QK_LCTL | (kc))
+#define LSFT(kc) (QK_LSFT | (kc))
+#define LALT(kc) (QK_LALT | (kc))
+#define LGUI(kc) (QK_LGUI | (kc))
+#define C(kc) LCTL(kc)
+#define S(kc) LSFT(kc)
+#define A(kc) LALT(kc)
+#define G(kc) LGUI(kc)
+
+#define QK_LAYER_MOD 0x5000
+#define QK_LAYER_MOD_MAX 0x51FF
+#define LM(layer, mod) (QK_LAYER_MOD | (((layer) & 0xF) << 5) | ((mod) & 0x1F))
+#define IS_QK_LAYER_MOD(kc) ((kc) >= QK_LAYER_MOD && (kc) <= QK_LAYER_MOD_MAX)
+#define QK_LAYER_MOD_GET_LAYER(kc) (((kc) >> 5) & 0xF)
+#define QK_LAYER_MOD_GET_MODS(kc) ((kc) & 0x1F)
+
+#define QK_MOMENTARY 0x5220
+#define MO(layer) (QK_MOMENTARY | ((layer) & 0x1F))
+#define IS_QK_MOMENTARY(kc) ((kc) >= QK_MOMENTARY && (kc) <= QK_MOMENTARY + 0x1F)
+#define QK_MOMENTARY_GET_LAYER(kc) ((kc) & 0x1F)
+
+#define QK_TOGGLE_LAYER 0x5260
+#define TG(layer) (QK_TOGGLE_LAYER | ((layer) & 0x1F))
+#define IS_QK_TOGGLE_LAYER(kc) ((kc) >= QK_TOGGLE_LAYER && (kc) <= QK_TOGGLE_LAYER + 0x1F)
+#define QK_TOGGLE_LAYER_GET_LAYER(kc) ((kc) & 0x1F)
+
+#define QK_TAP_DANCE 0x5700
+#define TD(n) (QK_TAP_DANCE | ((n) & 0xFF))
+#define IS_QK_TAP_DANCE(kc) ((kc) >= QK_TAP_DANCE && (kc) <= QK_TAP_DANCE + 0xFF)
+
+#define QK_LAYER_TAP 0x4000
+#define LT(layer, kc) (QK_LAYER_TAP | (((layer) & 0xF) << 8) | ((kc) & 0xFF))
+
+// lighting and firmware keycodes, only ever looked up in a keymap
+#define NK_TOGG 0x7013
+enum {
+    UG_TOGG = 0x7820,
+    UG_NEXT, UG_PREV, UG_HUEU, UG_HUED, UG_SATU, UG_SATD, UG_VALU, UG_VALD, UG_SPDU, UG_SPDD,
+    RM_ON   = 0x7840,
+    RM_OFF, RM_TOGG, RM_NEXT, RM_PREV, RM_HUEU, RM_HUED, RM_SATU, RM_SATD, RM_VALU, RM_VALD, RM_SPDU, RM_SPDD,
+    QK_BOOT = 0x7C00,
+};
+
+#define RGB_TOG UG_TOGG
+#define RGB_MOD UG_NEXT
+#define RGB_RMOD UG_PREV
+#define RGB_HUI UG_HUEU
+#define RGB_HUD UG_HUED
+#define RGB_SAI UG_SATU
+#define RGB_SAD UG_SATD
+#define RGB_VAI UG_VALU
+#define RGB_VAD UG_VALD
+#define RGB_SPI UG_SPDU
+#define RGB_SPD UG_SPDD
+
+#define QK_KB_0 0x7E00
+#define SAFE_RANGE 0x7E40
+
+/* Events */
+
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef enum {
+    TICK_EVENT = 0,
+    KEY_EVENT,
+    ENCODER_CW_EVENT,
+    ENCODER_CCW_EVENT,
+} keyevent_type_t;
+
+typedef struct {
+    keypos_t        key;
+    uint16_t        time;
+    keyevent_type_t type;
+    bool            pressed;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+#define KEYEQ(a, b) ((a).row == (b).row && (a).col == (b).col)
+#define IS_ENCODEREVENT(ev) ((ev).type == ENCODER_CW_EVENT || (ev).type == ENCODER_CCW_EVENT)
+
+/* Timers and deferred execution, driven by harness_tick() */
+
+uint16_t timer_read(void);
+uint32_t timer_read32(void);
+uint16_t timer_elapsed(uint16_t last);
+uint32_t timer_elapsed32(uint32_t last);
+
+typedef uint8_t deferred_token;
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+#define INVALID_DEFERRED_TOKEN 0
+
+deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg);
+bool           extend_deferred_exec(deferred_token token, uint32_t delay_ms);
+bool           cancel_deferred_exec(deferred_token token);
+
+/* Host side, logged */
+
+void register_code(uint8_t keycode);
+void unregister_code(uint8_t keycode);
+void tap_code(uint8_t keycode);
+void register_code16(uint16_t keycode);
+void unregister_code16(uint16_t keycode);
+void tap_code16(uint16_t keycode);
+void register_mods(uint8_t mods);
+void unregister_mods(uint8_t mods);
+void host_consumer_send(uint16_t usage);
+void action_exec(keyevent_t event);
+
+/* Layers */
+
+typedef uint32_t layer_state_t;
+
+extern layer_state_t layer_state;
+extern layer_state_t default_layer_state;
+
+uint8_t get_highest_layer(layer_state_t state);
+void    layer_on(uint8_t layer);
+void    layer_off(uint8_t layer);
+void    layer_invert(uint8_t layer);
+
+/* Keymap, provided by the tests that need one */
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key);
+uint8_t  keymap_layer_count(void);
+
+/* EEPROM user datablock, kept in RAM */
+
+void eeconfig_read_user_datablock(void *data, uint8_t offset, uint8_t size);
+void eeconfig_update_user_datablock(const void *data, uint8_t offset, uint8_t size);
+
+/* Tap dance */
+
+typedef struct {
+    uint16_t interrupting_keycode;
+    uint8_t  count;
+    uint8_t  weak_mods;
+    bool     pressed : 1;
+    bool     finished : 1;
+    bool     interrupted : 1;
+} tap_dance_state_t;
+
+typedef void (*tap_dance_user_fn_t)(tap_dance_state_t *state, void *user_data);
+
+typedef struct {
+    tap_dance_state_t state;
+    struct {
+        tap_dance_user_fn_t on_each_tap;
+        tap_dance_user_fn_t on_dance_finished;
+        tap_dance_user_fn_t on_reset;
+        tap_dance_user_fn_t on_each_release;
+    } fn;
+    void *user_data;
+} tap_dance_action_t;
+
+/* Pointing device */
+
+#ifdef WHEEL_EXTENDED_REPORT
+typedef int16_t mouse_hv_report_t;
+#else
+typedef int8_t mouse_hv_report_t;
+#endif
+
+typedef struct {
+    uint8_t           buttons;
+    int8_t            x;
+    int8_t            y;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
+} report_mouse_t;
+
+uint16_t pointing_device_get_hires_scroll_resolution(void);
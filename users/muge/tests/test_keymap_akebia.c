@@ -0,0 +1,115 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "keymap_host.h"
+
+// one flat matrix row in layout order; positions below are layout indices
+#define LAYOUT_ansi_82(...) {{__VA_ARGS__}}
+#include "../../../keyboards/keychron/v1_max/ansi_encoder/keymaps/akebia/keymap.c"
+
+_Static_assert(MATRIX_COLS == 82, "MATRIX_COLS must match the LAYOUT key count");
+
+#define POS_GRV 15 // KCGF_1 on WIN_BASE
+#define POS_1 16
+#define POS_CAPS 45 // MO(L1) on WIN_BASE, KCCF_1 stands in here
+#define POS_A 46
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return keymaps[layer][key.row][key.col];
+}
+
+uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+typedef struct {
+    uint16_t    keycode;
+    uint8_t     pos;
+    uint16_t    term;
+    const char *press;   // reports on press
+    const char *tap;     // reports for a release before the term
+    const char *hold;    // reports for a release at or past the term
+    uint8_t     probe;   // key whose report shows the held layer
+    const char *layered; // reports for a tap of the probe key while held
+} th_case_t;
+
+// clang-format off
+static const th_case_t th_cases[] = {
+    {KCCF_1, POS_CAPS, TAP_TIME_KCCF_1, "",       "[CAPS] []",    "",   POS_A, "[LEFT] []"},
+    {KCGF_1, POS_GRV,  TAP_TIME_KCGF_1, "[LCTL]", "[] [GRV] []", "[]", POS_1, "[LCTL F1] [LCTL]"},
+};
+// clang-format on
+
+_Static_assert(ARRAY_SIZE(th_cases) == TH_COUNT, "one case per th_keys[] row");
+
+// KCCF_1 is not in the keymap, KCGF_1 is looked up on WIN_BASE
+static void th(const th_case_t *c, bool pressed) {
+    keymap_host_key(0, c->pos, c->keycode == KCGF_1 ? KC_NO : c->keycode, pressed);
+}
+
+static void press_release(const th_case_t *c, uint16_t held, const char *release) {
+    th(c, true);
+    EXPECT_REPORTS(c->press);
+    harness_tick(held);
+    th(c, false);
+    EXPECT_REPORTS(release);
+    harness_discard();
+}
+
+static void every_row_taps_one_ms_before_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        EXPECT(th_keys[i].term == th_cases[i].term);
+        press_release(&th_cases[i], th_cases[i].term - 1, th_cases[i].tap);
+    }
+}
+
+static void every_row_holds_at_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        press_release(&th_cases[i], th_cases[i].term, th_cases[i].hold);
+    }
+}
+
+static void every_row_holds_one_ms_past_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        press_release(&th_cases[i], th_cases[i].term + 1, th_cases[i].hold);
+    }
+}
+
+static void every_row_holds_its_layer(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        const th_case_t *c = &th_cases[i];
+
+        th(c, true);
+        EXPECT_REPORTS(c->press);
+        harness_tick(c->term + 1);
+        keymap_host_key(0, c->probe, KC_NO, true);
+        keymap_host_key(0, c->probe, KC_NO, false);
+        EXPECT_REPORTS(c->layered);
+        th(c, false);
+        EXPECT_REPORTS(c->hold);
+        harness_discard();
+    }
+}
+
+static void bench(void) {
+    keymap_host_bench("plain key", 0, POS_A, KC_NO, 30, 10000);
+    keymap_host_bench("KCGF_1 tap", 0, POS_GRV, KC_NO, TAP_TIME_KCGF_1 / 2, 10000);
+    keymap_host_bench("KCGF_1 hold", 0, POS_GRV, KC_NO, TAP_TIME_KCGF_1 + 1, 10000);
+}
+
+int main(int argc, char **argv) {
+    // the DIP switch in the Windows position
+    default_layer_state = (layer_state_t)1 << WIN_BASE;
+    keyboard_post_init_user();
+
+    if (argc > 1 && !strcmp(argv[1], "bench")) {
+        bench();
+        return 0;
+    }
+    RUN_TEST(every_row_taps_one_ms_before_term);
+    RUN_TEST(every_row_holds_at_term);
+    RUN_TEST(every_row_holds_one_ms_past_term);
+    RUN_TEST(every_row_holds_its_layer);
+    return harness_summary();
+}
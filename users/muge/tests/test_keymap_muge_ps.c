@@ -0,0 +1,125 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "keymap_host.h"
+
+// one flat matrix row in layout order; positions below are layout indices
+#define LAYOUT(...) {{__VA_ARGS__}}
+#include "../../../keyboards/cxt_studio/12e3/keymaps/muge_ps/keymap.c"
+
+_Static_assert(MATRIX_COLS == 15, "MATRIX_COLS must match the LAYOUT key count");
+
+#define POS_CALC 8 // TH_* keys are not in the keymap, they stand in at this key
+#define POS_MO2 11
+#define POS_PGUP 8
+#define POS_PGDN 13
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return keymaps[layer][key.row][key.col];
+}
+
+uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymaps);
+}
+
+uint16_t pointing_device_get_hires_scroll_resolution(void) {
+    return 120;
+}
+
+typedef struct {
+    uint16_t    keycode;
+    const char *tap;  // reports for a release before the term
+    const char *hold; // reports at the term
+} th_case_t;
+
+// clang-format off
+static const th_case_t th_cases[] = {
+    {TH_DX,  "[D] []",                    "[X] []"},
+    {TH_BS,  "[B] []",                    "[S] []"},
+    {TH_JE,  "[LCTL] [LCTL J] [LCTL] []", "[E] []"},
+    {TH_VW,  "[V] []",                    "[W] []"},
+    {TH_GSP, "[G] []",                    "[SPC] []"},
+    {TH_ML,  "[M] []",                    "[L] []"},
+    {TH_F1D, "[F] []",                    "[LCTL] [LCTL D] [LCTL] []"},
+    {TH_05,  "[0] []",                    "[5] []"},
+    {TH_1T,  "[LCTL] [LCTL 1] [LCTL] []", "[LCTL] [LCTL T] [LCTL] []"},
+    {TH_CX,  "[LCTL] [LCTL C] [LCTL] []", "[LCTL] [LCTL X] [LCTL] []"},
+    {TH_PST, "[LCTL] [LCTL V] [LCTL] []", "[LCTL|LSFT] [LCTL|LSFT V] [LCTL|LSFT] []"},
+    {TH_SAV, "[LCTL] [LCTL S] [LCTL] []", "[LCTL|LSFT] [LCTL|LSFT S] [LCTL|LSFT] []"},
+};
+// clang-format on
+
+_Static_assert(ARRAY_SIZE(th_cases) == TH_COUNT, "one case per th_keys[] row");
+
+static void th(uint16_t keycode, bool pressed) {
+    keymap_host_key(0, POS_CALC, keycode, pressed);
+}
+
+static void every_row_taps_one_ms_before_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        EXPECT(th_keys[i].term == TAP_TIME_DEF);
+        th(th_cases[i].keycode, true);
+        harness_tick(TAP_TIME_DEF - 1);
+        EXPECT_REPORTS("");
+        th(th_cases[i].keycode, false);
+        EXPECT_REPORTS(th_cases[i].tap);
+        harness_discard();
+    }
+}
+
+static void every_row_holds_at_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        th(th_cases[i].keycode, true);
+        harness_tick(TAP_TIME_DEF - 1);
+        EXPECT_REPORTS("");
+        harness_tick(1);
+        EXPECT_REPORTS(th_cases[i].hold);
+        th(th_cases[i].keycode, false);
+        EXPECT_REPORTS("");
+        harness_discard();
+    }
+}
+
+static void every_row_holds_one_ms_past_term(void) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(th_cases); i++) {
+        th(th_cases[i].keycode, true);
+        harness_tick(TAP_TIME_DEF + 1);
+        EXPECT_REPORTS(th_cases[i].hold);
+        th(th_cases[i].keycode, false);
+        EXPECT_REPORTS("");
+        harness_discard();
+    }
+}
+
+static void rgb_layer_sends_page_up_and_down(void) {
+    keymap_host_key(0, POS_MO2, KC_NO, true);
+    keymap_host_key(0, POS_PGUP, KC_NO, true);
+    keymap_host_key(0, POS_PGUP, KC_NO, false);
+    keymap_host_key(0, POS_PGDN, KC_NO, true);
+    keymap_host_key(0, POS_PGDN, KC_NO, false);
+    keymap_host_key(0, POS_MO2, KC_NO, false);
+    EXPECT_REPORTS("[PGUP] [] [PGDN] []");
+    harness_discard();
+}
+
+static void bench(void) {
+    keymap_host_bench("plain key", 0, POS_MO2 + 1, KC_NO, 30, 10000);
+    keymap_host_bench("TH_DX tap", 0, POS_CALC, TH_DX, TAP_TIME_DEF / 2, 10000);
+    keymap_host_bench("TH_DX hold", 0, POS_CALC, TH_DX, TAP_TIME_DEF + 1, 10000);
+    keymap_host_bench("TH_GSP repeat", 0, POS_CALC, TH_GSP, 1000, 1000);
+}
+
+int main(int argc, char **argv) {
+    keyboard_post_init_user();
+
+    if (argc > 1 && !strcmp(argv[1], "bench")) {
+        bench();
+        return 0;
+    }
+    RUN_TEST(every_row_taps_one_ms_before_term);
+    RUN_TEST(every_row_holds_at_term);
+    RUN_TEST(every_row_holds_one_ms_past_term);
+    RUN_TEST(rgb_layer_sends_page_up_and_down);
+    return harness_summary();
+}
@@ -0,0 +1,140 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "knob.h"
+
+#define ZOOM_IN SAFE_RANGE
+
+// clang-format off
+const knob_curve_t PROGMEM knob_curves[][NUM_ENCODERS] = {
+    {KNOB_CURVE(40, 4)},
+};
+// clang-format on
+
+const uint8_t knob_curve_layers = ARRAY_SIZE(knob_curves);
+
+uint16_t pointing_device_get_hires_scroll_resolution(void) {
+    return 1;
+}
+
+// One encoder-map detent: a press and a release of the mapped keycode.
+static void detent(uint16_t keycode, bool clockwise) {
+    keyrecord_t record = harness_encoder(0, clockwise);
+
+    if (knob_process_record(keycode, &record)) {
+        if (keycode == ZOOM_IN) {
+            knob_mod_wheel(MS_WHLU, MOD_BIT(KC_LALT));
+        } else {
+            register_code16(keycode);
+        }
+    }
+    record.event.pressed = false;
+    if (knob_process_record(keycode, &record) && keycode != ZOOM_IN) {
+        unregister_code16(keycode);
+    }
+}
+
+static report_mouse_t report(void) {
+    return knob_pointing_device_task((report_mouse_t){0});
+}
+
+static void slow_detents_send_one_step(void) {
+    detent(KC_A, true);
+    harness_tick(40);
+    detent(KC_A, true);
+    EXPECT_LOG("+A -A +A -A");
+    EXPECT(knob_steps() == 1);
+}
+
+static void fast_detents_accelerate(void) {
+    detent(KC_A, true);
+    harness_tick(10);
+    // 1 + (40 - 10) * (4 - 1) / 40 = 3 steps
+    detent(KC_A, true);
+    EXPECT(knob_steps() == 3);
+    EXPECT_LOG("+A -A +A -A +A -A +A -A");
+}
+
+static void direction_change_does_not_accelerate(void) {
+    detent(KC_A, true);
+    harness_tick(5);
+    detent(KC_B, false);
+    EXPECT(knob_steps() == 1);
+    EXPECT_LOG("+A -A +B -B");
+}
+
+static void wheel_detents_coalesce(void) {
+    for (uint8_t i = 0; i < 3; i++) {
+        harness_tick(100);
+        detent(MS_WHLU, true);
+    }
+    EXPECT(report().v == 3);
+    EXPECT(report().v == 0);
+    EXPECT_LOG("");
+}
+
+static void wheel_backlog_is_clamped_per_report(void) {
+    for (uint8_t i = 0; i < 130; i++) {
+        harness_tick(100);
+        detent(MS_WHLD, false);
+    }
+    EXPECT(report().v == -127);
+    EXPECT(report().v == -3);
+    EXPECT(report().v == 0);
+}
+
+static void consumer_detents_queue(void) {
+    harness_tick(100);
+    detent(KC_VOLU, true);
+    harness_tick(100);
+    detent(KC_VOLU, true);
+    EXPECT_LOG("");
+    knob_task();
+    EXPECT_LOG("+VOLU -VOLU");
+    knob_task();
+    knob_task();
+    EXPECT_LOG("+VOLU -VOLU");
+}
+
+static void mod_wheel_releases_mods_after_report(void) {
+    harness_tick(100);
+    detent(ZOOM_IN, true);
+    harness_tick(100);
+    detent(ZOOM_IN, true);
+    EXPECT_LOG("+LALT");
+    knob_task();
+    EXPECT_LOG("");
+    EXPECT(report().v == 2);
+    EXPECT_LOG("");
+    knob_task();
+    EXPECT_LOG("-LALT");
+    knob_task();
+    EXPECT_LOG("");
+}
+
+static void mod_wheel_holds_mods_until_backlog_is_sent(void) {
+    for (uint8_t i = 0; i < 130; i++) {
+        harness_tick(100);
+        detent(ZOOM_IN, true);
+    }
+    EXPECT_LOG("+LALT");
+    EXPECT(report().v == 127);
+    knob_task();
+    EXPECT_LOG("");
+    EXPECT(report().v == 3);
+    knob_task();
+    EXPECT_LOG("-LALT");
+}
+
+int main(void) {
+    RUN_TEST(slow_detents_send_one_step);
+    RUN_TEST(fast_detents_accelerate);
+    RUN_TEST(direction_change_does_not_accelerate);
+    RUN_TEST(wheel_detents_coalesce);
+    RUN_TEST(wheel_backlog_is_clamped_per_report);
+    RUN_TEST(consumer_detents_queue);
+    RUN_TEST(mod_wheel_releases_mods_after_report);
+    RUN_TEST(mod_wheel_holds_mods_until_backlog_is_sent);
+    return harness_summary();
+}
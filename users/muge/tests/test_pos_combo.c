@@ -0,0 +1,147 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "pos_combo.h"
+
+// clang-format off
+static const uint16_t keymap[][MATRIX_ROWS][MATRIX_COLS] = {
+    {
+        {KC_A,    KC_B,    KC_C,    KC_D},
+        {KC_X,    KC_Y,    KC_Z,    KC_SPC},
+    },
+    {
+        {KC_TRNS, KC_TRNS, KC_TRNS, KC_TRNS},
+        {KC_TRNS, KC_TRNS, KC_TRNS, KC_ESC},
+    },
+};
+
+const pos_combo_t PROGMEM pos_combos[] = {
+    POS_COMBO(KC_ESC, KC_A, KC_B),
+    POS_COMBO(TG(1),  KC_C, KC_D),
+    POS_COMBO(KC_TAB, KC_A, KC_B, KC_C),
+    POS_COMBO(KC_SPC, KC_X, KC_Y),
+};
+// clang-format on
+
+const uint8_t pos_combo_count = ARRAY_SIZE(pos_combos);
+_Static_assert(ARRAY_SIZE(pos_combos) <= POS_COMBO_MAX, "raise POS_COMBO_MAX in config.h");
+
+uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    return keymap[layer][key.row][key.col];
+}
+
+uint8_t keymap_layer_count(void) {
+    return ARRAY_SIZE(keymap);
+}
+
+static void process(keyevent_t event) {
+    keyrecord_t record = {.event = event};
+
+    // muge.c: pre_process_record_user()
+    if (pos_combo_pre_process_record(&record)) {
+        harness_log("key:%u,%u%c", event.key.row, event.key.col, event.pressed ? '+' : '-');
+    }
+}
+
+// replayed presses go through the same pipeline
+void action_exec(keyevent_t event) {
+    process(event);
+}
+
+static void key(uint8_t row, uint8_t col, bool pressed) {
+    process(harness_key(row, col, pressed).event);
+}
+
+static void waits_for_longer_combo_then_fires(void) {
+    key(0, 0, true);
+    key(0, 1, true);
+    harness_tick(POS_COMBO_TERM - 1);
+    EXPECT_LOG("");
+    harness_tick(1);
+    EXPECT_LOG("+ESC");
+    key(0, 0, false);
+    EXPECT_LOG("-ESC");
+    key(0, 1, false);
+    EXPECT_LOG("");
+}
+
+static void fires_early_without_longer_candidate(void) {
+    key(0, 2, true);
+    key(0, 3, true);
+    EXPECT_LOG("L1+");
+    key(0, 2, false);
+    key(0, 3, false);
+    EXPECT_LOG("");
+
+    // resolved again on layer 1, where the keys fall through
+    key(0, 2, true);
+    key(0, 3, true);
+    key(0, 3, false);
+    key(0, 2, false);
+    EXPECT_LOG("L1-");
+}
+
+static void three_key_combo(void) {
+    key(0, 0, true);
+    key(0, 1, true);
+    key(0, 2, true);
+    EXPECT_LOG("+TAB");
+    key(0, 1, false);
+    EXPECT_LOG("-TAB");
+    key(0, 0, false);
+    key(0, 2, false);
+    EXPECT_LOG("");
+}
+
+static void overlapping_combos_release_independently(void) {
+    key(0, 0, true);
+    key(0, 1, true);
+    harness_tick(POS_COMBO_TERM);
+    key(1, 0, true);
+    key(1, 1, true);
+    EXPECT_LOG("+ESC +SPC");
+    key(0, 1, false);
+    EXPECT_LOG("-ESC");
+    key(1, 0, false);
+    EXPECT_LOG("-SPC");
+    key(0, 0, false);
+    key(1, 1, false);
+    EXPECT_LOG("");
+}
+
+static void non_combo_key_replays_in_order(void) {
+    key(0, 0, true);
+    key(1, 2, true);
+    EXPECT_LOG("key:0,0+ key:1,2+");
+    key(0, 0, false);
+    key(1, 2, false);
+    EXPECT_LOG("key:0,0- key:1,2-");
+}
+
+static void lone_key_replayed_on_timeout(void) {
+    key(0, 0, true);
+    harness_tick(POS_COMBO_TERM);
+    EXPECT_LOG("key:0,0+");
+    key(0, 0, false);
+    EXPECT_LOG("key:0,0-");
+}
+
+static void quick_tap_replayed_on_release(void) {
+    key(0, 1, true);
+    key(0, 1, false);
+    EXPECT_LOG("key:0,1+ key:0,1-");
+}
+
+int main(void) {
+    pos_combo_init();
+
+    RUN_TEST(waits_for_longer_combo_then_fires);
+    RUN_TEST(fires_early_without_longer_candidate);
+    RUN_TEST(three_key_combo);
+    RUN_TEST(overlapping_combos_release_independently);
+    RUN_TEST(non_combo_key_replays_in_order);
+    RUN_TEST(lone_key_replayed_on_timeout);
+    RUN_TEST(quick_tap_replayed_on_release);
+    return harness_summary();
+}
@@ -0,0 +1,216 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "tap_dance.h"
+
+#define TAPPING_TERM 200
+
+enum { TD_FULL, TD_PERM, TD_SINGLE, TD_LM };
+
+// clang-format off
+const td_row_t PROGMEM td_rows[] = {
+    [TD_FULL]   = {KC_A,   MO(1),             KC_B,  KC_NO, KC_C,  0},
+    [TD_PERM]   = {KC_X,   MO(1),             KC_NO, KC_NO, KC_NO, TD_F_PERMISSIVE},
+    [TD_SINGLE] = {KC_Z,   KC_NO,             KC_NO, KC_NO, KC_NO, 0},
+    [TD_LM]     = {KC_TAB, LM(1, MOD_LCTL),   KC_NO, KC_NO, KC_NO, 0},
+};
+
+static tap_dance_action_t actions[] = {
+    [TD_FULL]   = ACTION_TAP_DANCE_ROW(TD_FULL),
+    [TD_PERM]   = ACTION_TAP_DANCE_ROW(TD_PERM),
+    [TD_SINGLE] = ACTION_TAP_DANCE_ROW(TD_SINGLE),
+    [TD_LM]     = ACTION_TAP_DANCE_ROW(TD_LM),
+};
+// clang-format on
+
+/* The parts of quantum/process_keycode/process_tap_dance.c the rows rely on:
+ * each tap counts, another key interrupts, the term finishes the dance and
+ * a finished dance resets once its key is up.
+ */
+
+static tap_dance_action_t *active;
+static uint16_t            last_tap;
+
+static void td_reset(tap_dance_action_t *action) {
+    action->fn.on_reset(&action->state, action->user_data);
+    action->state = (tap_dance_state_t){0};
+    if (active == action) {
+        active = NULL;
+    }
+}
+
+static void td_finish(tap_dance_action_t *action) {
+    if (!action->state.finished) {
+        action->state.finished = true;
+        action->fn.on_dance_finished(&action->state, action->user_data);
+    }
+    if (!action->state.pressed) {
+        td_reset(action);
+    }
+}
+
+static void td_task(void) {
+    if (active && timer_elapsed(last_tap) > TAPPING_TERM) {
+        td_finish(active);
+    }
+}
+
+static void tick(uint32_t ms) {
+    while (ms--) {
+        harness_tick(1);
+        td_task();
+    }
+}
+
+static void process(keyevent_t event) {
+    bool        is_dance = event.key.row == 1;
+    uint16_t    keycode  = is_dance ? TD(event.key.col) : KC_NO;
+    keyrecord_t record   = {.event = event};
+
+    // muge.c: pre_process_record_user()
+    if (!td_pre_process_record(keycode, &record)) {
+        return;
+    }
+    if (event.pressed && active && (!is_dance || active != &actions[event.key.col])) {
+        active->state.interrupted = true;
+        td_finish(active);
+        active = NULL;
+    }
+    if (!is_dance) {
+        harness_log("key:%u,%u%c", event.key.row, event.key.col, event.pressed ? '+' : '-');
+        return;
+    }
+
+    tap_dance_action_t *action = &actions[event.key.col];
+
+    action->state.pressed = event.pressed;
+    if (event.pressed) {
+        last_tap = timer_read();
+        action->state.count++;
+        action->fn.on_each_tap(&action->state, action->user_data);
+        active = action->state.finished ? NULL : action;
+    } else {
+        action->fn.on_each_release(&action->state, action->user_data);
+        if (action->state.finished) {
+            td_reset(action);
+        }
+    }
+}
+
+// replayed events go through the same pipeline
+void action_exec(keyevent_t event) {
+    process(event);
+}
+
+static void dance(uint8_t index, bool pressed) {
+    process(harness_key(1, index, pressed).event);
+}
+
+static void key(uint8_t col, bool pressed) {
+    process(harness_key(0, col, pressed).event);
+}
+
+static void tap_resolves_after_term(void) {
+    dance(TD_FULL, true);
+    dance(TD_FULL, false);
+    tick(TAPPING_TERM);
+    EXPECT_LOG("");
+    tick(1);
+    EXPECT_LOG("+A -A");
+}
+
+static void hold_keeps_layer_until_release(void) {
+    dance(TD_FULL, true);
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("L1+");
+    dance(TD_FULL, false);
+    EXPECT_LOG("L1-");
+}
+
+static void double_and_triple_tap(void) {
+    dance(TD_FULL, true);
+    dance(TD_FULL, false);
+    dance(TD_FULL, true);
+    dance(TD_FULL, false);
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("+B -B");
+
+    for (uint8_t i = 0; i < 3; i++) {
+        dance(TD_FULL, true);
+        dance(TD_FULL, false);
+    }
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("+C -C");
+}
+
+static void interrupt_resolves_as_tap(void) {
+    dance(TD_FULL, true);
+    key(0, true);
+    EXPECT_LOG("+A key:0,0+");
+    key(0, false);
+    dance(TD_FULL, false);
+    EXPECT_LOG("key:0,0- -A");
+}
+
+static void single_only_row_resolves_on_release(void) {
+    dance(TD_SINGLE, true);
+    EXPECT_LOG("");
+    dance(TD_SINGLE, false);
+    EXPECT_LOG("+Z -Z");
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("");
+}
+
+static void layer_mod_hold_releases_in_reverse(void) {
+    dance(TD_LM, true);
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("L1+ +LCTL");
+    dance(TD_LM, false);
+    EXPECT_LOG("-LCTL L1-");
+}
+
+static void permissive_roll_resolves_as_hold(void) {
+    dance(TD_PERM, true);
+    key(0, true);
+    EXPECT_LOG("");
+    key(0, false);
+    EXPECT_LOG("L1+ key:0,0+ key:0,0-");
+    dance(TD_PERM, false);
+    EXPECT_LOG("L1-");
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("");
+}
+
+static void permissive_release_first_resolves_as_tap(void) {
+    dance(TD_PERM, true);
+    key(0, true);
+    EXPECT_LOG("");
+    dance(TD_PERM, false);
+    EXPECT_LOG("+X key:0,0+ -X");
+    key(0, false);
+    EXPECT_LOG("key:0,0-");
+}
+
+static void permissive_term_replays_held_keys(void) {
+    dance(TD_PERM, true);
+    key(0, true);
+    tick(TAPPING_TERM + 1);
+    EXPECT_LOG("L1+ key:0,0+");
+    key(0, false);
+    dance(TD_PERM, false);
+    EXPECT_LOG("key:0,0- L1-");
+}
+
+int main(void) {
+    RUN_TEST(tap_resolves_after_term);
+    RUN_TEST(hold_keeps_layer_until_release);
+    RUN_TEST(double_and_triple_tap);
+    RUN_TEST(interrupt_resolves_as_tap);
+    RUN_TEST(single_only_row_resolves_on_release);
+    RUN_TEST(layer_mod_hold_releases_in_reverse);
+    RUN_TEST(permissive_roll_resolves_as_hold);
+    RUN_TEST(permissive_release_first_resolves_as_tap);
+    RUN_TEST(permissive_term_replays_held_keys);
+    return harness_summary();
+}
@@ -0,0 +1,143 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "tap_hold.h"
+
+enum {
+    TH_PLAIN,   // A, C(B) on release past the term
+    TH_EAGER,   // C, D at the term
+    TH_REPEAT,  // E, F at the term and repeating
+    TH_INSTANT, // ESC, layer 1 + LSFT from the press
+    TH_SPARE,   // X, Z
+};
+
+// clang-format off
+const th_key_t PROGMEM th_keys[] = {
+    [TH_PLAIN]   = TAP_HOLD(KC_A, 0, KC_B, MOD_BIT(KC_LCTL), 0,                        200),
+    [TH_EAGER]   = TAP_HOLD(KC_C, 0, KC_D, 0,                TH_F_EAGER,               200),
+    [TH_REPEAT]  = TAP_HOLD(KC_E, 0, KC_F, 0,                TH_F_EAGER | TH_F_REPEAT, 200),
+    [TH_INSTANT] = TAP_HOLD_LAYER(KC_ESC, 1, MOD_BIT(KC_LSFT), 150),
+    [TH_SPARE]   = TAP_HOLD(KC_X, 0, KC_Z, 0,                0,                        200),
+};
+// clang-format on
+
+const uint8_t th_key_count = ARRAY_SIZE(th_keys);
+
+static void th(uint8_t index, bool pressed) {
+    keyrecord_t record = harness_key(0, index, pressed);
+
+    EXPECT(!process_tap_hold(index, &record));
+}
+
+static void tap_just_below_term(void) {
+    th(TH_PLAIN, true);
+    harness_tick(199);
+    th(TH_PLAIN, false);
+    EXPECT_LOG("+A -A");
+}
+
+static void hold_sent_on_release_at_term(void) {
+    th(TH_PLAIN, true);
+    harness_tick(200);
+    EXPECT_LOG("");
+    th(TH_PLAIN, false);
+    EXPECT_LOG("+LCTL +B -B -LCTL");
+}
+
+static void eager_fires_at_term(void) {
+    th(TH_EAGER, true);
+    harness_tick(199);
+    EXPECT_LOG("");
+    harness_tick(1);
+    EXPECT_LOG("+D -D");
+    th(TH_EAGER, false);
+    EXPECT_LOG("");
+}
+
+static void eager_cancelled_by_early_release(void) {
+    th(TH_EAGER, true);
+    harness_tick(199);
+    th(TH_EAGER, false);
+    EXPECT_LOG("+C -C");
+    harness_tick(50);
+    EXPECT_LOG("");
+}
+
+static void repeat_accelerates(void) {
+    th(TH_REPEAT, true);
+    harness_tick(200);
+    EXPECT_LOG("+F -F");
+    harness_tick(TH_REPEAT_DELAY - 1);
+    EXPECT_LOG("");
+    harness_tick(1);
+    EXPECT_LOG("+F -F");
+    // 100 ms, then 80 % of the previous interval each time
+    harness_tick(100);
+    EXPECT_LOG("+F -F");
+    harness_tick(79);
+    EXPECT_LOG("");
+    harness_tick(1);
+    EXPECT_LOG("+F -F");
+    harness_tick(64);
+    EXPECT_LOG("+F -F");
+    th(TH_REPEAT, false);
+    EXPECT_LOG("");
+    harness_tick(100);
+    EXPECT_LOG("");
+}
+
+static void instant_tap(void) {
+    th(TH_INSTANT, true);
+    EXPECT_LOG("L1+ +LSFT");
+    harness_tick(149);
+    th(TH_INSTANT, false);
+    EXPECT_LOG("-LSFT L1- +ESC -ESC");
+}
+
+static void instant_hold(void) {
+    th(TH_INSTANT, true);
+    harness_tick(150);
+    th(TH_INSTANT, false);
+    EXPECT_LOG("L1+ +LSFT -LSFT L1-");
+}
+
+static void no_free_slot_falls_back_to_tap(void) {
+    th(TH_PLAIN, true);
+    th(TH_EAGER, true);
+    th(TH_REPEAT, true);
+    th(TH_INSTANT, true);
+    EXPECT_LOG("L1+ +LSFT");
+    th(TH_SPARE, true);
+    harness_tick(300);
+    EXPECT_LOG("+D -D +F -F");
+    th(TH_SPARE, false);
+    EXPECT_LOG("+X -X");
+
+    th(TH_INSTANT, false);
+    th(TH_REPEAT, false);
+    th(TH_EAGER, false);
+    th(TH_PLAIN, false);
+    EXPECT_LOG("-LSFT L1- +LCTL +B -B -LCTL");
+}
+
+static void out_of_range_index_passes_through(void) {
+    keyrecord_t record = harness_key(0, 0, true);
+
+    EXPECT(process_tap_hold(th_key_count, &record));
+}
+
+int main(void) {
+    tap_hold_init();
+
+    RUN_TEST(tap_just_below_term);
+    RUN_TEST(hold_sent_on_release_at_term);
+    RUN_TEST(eager_fires_at_term);
+    RUN_TEST(eager_cancelled_by_early_release);
+    RUN_TEST(repeat_accelerates);
+    RUN_TEST(instant_tap);
+    RUN_TEST(instant_hold);
+    RUN_TEST(no_free_slot_falls_back_to_tap);
+    RUN_TEST(out_of_range_index_passes_through);
+    return harness_summary();
+}
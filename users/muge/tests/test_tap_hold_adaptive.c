@@ -0,0 +1,63 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "harness.h"
+#include "tap_hold.h"
+
+// clang-format off
+const th_key_t PROGMEM th_keys[] = {
+    TAP_HOLD(KC_A, 0, KC_B, 0, 0, 200),
+};
+// clang-format on
+
+const uint8_t th_key_count = ARRAY_SIZE(th_keys);
+
+static void press_for(uint16_t ms) {
+    keyrecord_t down = harness_key(0, 0, true);
+    keyrecord_t up   = harness_key(0, 0, false);
+
+    process_tap_hold(0, &down);
+    harness_tick(ms);
+    up.event.time = timer_read();
+    process_tap_hold(0, &up);
+}
+
+static void starts_from_table_term(void) {
+    press_for(199);
+    EXPECT_LOG("+A -A");
+    press_for(200);
+    EXPECT_LOG("+B -B");
+}
+
+// 60 ms taps and 300 ms holds leave a valley at the 80-99 ms bucket; the
+// term moves a quarter of the way there, 200 + (90 - 200) / 4 = 173.
+static void term_moves_towards_valley(void) {
+    // starts_from_table_term() already recorded two samples
+    for (uint8_t i = 0; i < TH_ADAPT_SAMPLES / 2 - 1; i++) {
+        press_for(60);
+        press_for(300);
+    }
+    EXPECT_LOG("+A -A +B -B +A -A +B -B +A -A +B -B +A -A +B -B +A -A +B -B +A -A +B -B +A -A +B -B");
+
+    press_for(172);
+    EXPECT_LOG("+A -A");
+    press_for(173);
+    EXPECT_LOG("+B -B");
+
+    // the learned term is written once, TH_FLUSH_DELAY after the change
+    uint16_t term;
+
+    EXPECT(harness_eeprom_writes == 0);
+    harness_tick(TH_FLUSH_DELAY);
+    EXPECT(harness_eeprom_writes == 1);
+    memcpy(&term, harness_eeprom, sizeof(term));
+    EXPECT(term == 173);
+}
+
+int main(void) {
+    tap_hold_init();
+
+    RUN_TEST(starts_from_table_term);
+    RUN_TEST(term_moves_towards_valley);
+    return harness_summary();
+}
@@ -0,0 +1,48 @@
+// Copyright 2026 muge
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "quantum.h"
+
+/* Free-running high resolution clock for measurements.
+ *
+ * ARMv7-M parts use the DWT cycle counter. The RP2040 has none, so it reads
+ * the 1 MHz system timer instead. Anything else falls back to the millisecond
+ * timer. timing_now() wraps; only differences between two reads are
+ * meaningful.
+ */
+#if defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)
+#    define TIMING_TICKS_PER_US (CPU_CLOCK / 1000000)
+
+static inline void timing_init(void) {
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t timing_now(void) {
+    return DWT->CYCCNT;
+}
+#elif defined(MCU_RP)
+#    include "hardware/timer.h"
+#    define TIMING_TICKS_PER_US 1
+
+static inline void timing_init(void) {}
+
+static inline uint32_t timing_now(void) {
+    return time_us_32();
+}
+#else
+#    define TIMING_TICKS_PER_US 1
+
+static inline void timing_init(void) {}
+
+static inline uint32_t timing_now(void) {
+    return timer_read32() * 1000;
+}
+#endif
+
+static inline uint32_t timing_ticks_to_ns(uint32_t ticks) {
+    return ticks * 1000 / TIMING_TICKS_PER_US;
+}